@@ -49,7 +49,7 @@ static void freeAstChildren(AstArray* children, bool freeChildren) {
 static bool astOwnsSymbolTable(Ast* ast) {
     if (ast->symtab == NULL || ast->symtab->id < 0) return false;
     if (ast->parent == NULL || ast->parent->symtab == NULL) return false;
-    return (ast->symtab->id != ast->parent->symtab->id);
+    return (ast->symtab != ast->parent->symtab && ast->symtab->parent == ast->parent->symtab);
 }
 
 void freeAst(Ast* ast, bool freeChildren) {
@@ -81,6 +81,7 @@ typedef enum {
 
 typedef struct {
     bool isAsync;
+    bool isBorrowed;
     bool isClass;
     bool isInitializer;
     bool isLambda;
@@ -106,6 +107,7 @@ struct Ast {
 static inline AstModifier astInitModifier() {
     return (AstModifier) {
         .isAsync = false,
+        .isBorrowed = false,
         .isClass = false,
         .isInitializer = false,
         .isLambda = false,
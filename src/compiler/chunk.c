@@ -77,6 +77,9 @@ int opCodeOffset(Chunk* chunk, int ip) {
         case OP_DEFINE_GLOBAL_VAR: return 2;
         case OP_GET_GLOBAL: return 2;
         case OP_SET_GLOBAL: return 2;
+        case OP_GET_GLOBAL_VAL: return 2;
+        case OP_GET_GLOBAL_VAR: return 2;
+        case OP_SET_GLOBAL_VAR: return 2;
         case OP_GET_UPVALUE: return 2;
         case OP_SET_UPVALUE: return 2;
         case OP_GET_PROPERTY: return 2;
@@ -90,6 +93,7 @@ int opCodeOffset(Chunk* chunk, int ip) {
         case OP_GREATER: return 1;
         case OP_LESS: return 1;
         case OP_ADD: return 1;
+        case OP_BUILD_STRING: return 2;
         case OP_SUBTRACT: return 1;
         case OP_MULTIPLY: return 1;
         case OP_DIVIDE: return 1;
@@ -101,15 +105,19 @@ int opCodeOffset(Chunk* chunk, int ip) {
         case OP_JUMP: return 3;
         case OP_JUMP_IF_FALSE: return 3;
         case OP_JUMP_IF_EMPTY: return 3;
+        case OP_JUMP_IF_INT_BOUNDS: return 3;
         case OP_LOOP: return 3;
+        case OP_FOR_ITER: return 7;
+        case OP_FOR_ITER_RANGE: return 7;
         case OP_CALL: return 2;
         case OP_OPTIONAL_CALL: return 2;
         case OP_INVOKE: return 3;
         case OP_SUPER_INVOKE: return 3;
         case OP_OPTIONAL_INVOKE: return 3;
-        case OP_CLOSURE: {
-            int constant = (chunk->code[ip + 1] << 8) | chunk->code[ip + 2];
-            ObjFunction* function = AS_FUNCTION(chunk->constants.values[constant]);
+        case OP_CLOSURE:
+        case OP_BORROW_CLOSURE: {
+            int identifier = chunk->code[ip + 1];
+            ObjFunction* function = AS_FUNCTION(chunk->identifiers.values[identifier]);
             return 2 + (function->upvalueCount * 2);
         }
         case OP_CLOSE_UPVALUE: return 1;
@@ -16,6 +16,9 @@ typedef enum {
     OP_DEFINE_GLOBAL_VAR,
     OP_GET_GLOBAL,
     OP_SET_GLOBAL,
+    OP_GET_GLOBAL_VAL,
+    OP_GET_GLOBAL_VAR,
+    OP_SET_GLOBAL_VAR,
     OP_GET_UPVALUE,
     OP_SET_UPVALUE,
     OP_GET_PROPERTY,
@@ -29,6 +32,7 @@ typedef enum {
     OP_GREATER,
     OP_LESS,
     OP_ADD,
+    OP_BUILD_STRING,
     OP_SUBTRACT,
     OP_MULTIPLY,
     OP_DIVIDE,
@@ -40,13 +44,17 @@ typedef enum {
     OP_JUMP,
     OP_JUMP_IF_FALSE,
     OP_JUMP_IF_EMPTY,
+    OP_JUMP_IF_INT_BOUNDS,
     OP_LOOP,
+    OP_FOR_ITER,
+    OP_FOR_ITER_RANGE,
     OP_CALL,
     OP_OPTIONAL_CALL,
     OP_INVOKE,
     OP_SUPER_INVOKE,
     OP_OPTIONAL_INVOKE,
     OP_CLOSURE,
+    OP_BORROW_CLOSURE,
     OP_CLOSE_UPVALUE,
     OP_CLASS,
     OP_TRAIT,
@@ -78,6 +86,7 @@ typedef enum {
 typedef enum {
     CACHE_NONE,
     CACHE_IVAR,
+    CACHE_TRANSITION,
     CACHE_CVAR,
     CACHE_GVAL,
     CACHE_GVAR,
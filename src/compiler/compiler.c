@@ -116,6 +116,14 @@ static int emitJump(Compiler* compiler, uint8_t instruction) {
     return currentChunk(compiler)->count - 2;
 }
 
+static int emitIterate(Compiler* compiler, uint8_t instruction, int collectionSlot, int indexSlot) {
+    emitByte(compiler, instruction);
+    emitBytes(compiler, collectionSlot, indexSlot);
+    emitBytes(compiler, 0xff, 0xff);
+    emitBytes(compiler, 0xff, 0xff);
+    return currentChunk(compiler)->count - 4;
+}
+
 static void emitLoop(Compiler* compiler) {
     emitByte(compiler, OP_LOOP);
     int offset = currentChunk(compiler)->count - compiler->currentLoop->start + 2;
@@ -136,7 +144,9 @@ static void emitReturn(Compiler* compiler, uint8_t depth) {
 }
 
 static uint8_t makeConstant(Compiler* compiler, Value value) {
-    int constant = addConstant(compiler->vm, currentChunk(compiler), value);
+    VM* vm = compiler->vm;
+    int constant = addConstant(vm, currentChunk(compiler), value);
+    PROCESS_WRITE_BARRIER((Obj*)compiler->function, value);
     if (constant > UINT8_MAX) {
         compileError(compiler, "Too many constants in one chunk.");
         return 0;
@@ -157,6 +167,15 @@ static void patchJump(Compiler* compiler, int offset) {
     currentChunk(compiler)->code[offset + 1] = jump & 0xff;
 }
 
+static void patchIterate(Compiler* compiler, int offset, int base) {
+    int jump = currentChunk(compiler)->count - base;
+    if (jump > UINT16_MAX) {
+        compileError(compiler, "Too much code to jump over.");
+    }
+    currentChunk(compiler)->code[offset] = (jump >> 8) & 0xff;
+    currentChunk(compiler)->code[offset + 1] = jump & 0xff;
+}
+
 static void patchAddress(Compiler* compiler, int offset) {
     currentChunk(compiler)->code[offset] = (currentChunk(compiler)->count >> 8) & 0xff;
     currentChunk(compiler)->code[offset + 1] = currentChunk(compiler)->count & 0xff;
@@ -313,7 +332,9 @@ static uint8_t makeIdentifier(Compiler* compiler, Value value) {
     int identifier;
 
     if (!idMapGet(&compiler->indexes, name, &identifier)) {
-        identifier = addIdentifier(compiler->vm, currentChunk(compiler), value);
+        VM* vm = compiler->vm;
+        identifier = addIdentifier(vm, currentChunk(compiler), value);
+        PROCESS_WRITE_BARRIER((Obj*)compiler->function, value);
         if (identifier > UINT8_MAX) {
             compileError(compiler, "Too many identifiers in one chunk.");
             return -1;
@@ -330,6 +351,14 @@ static uint8_t identifierConstant(Compiler* compiler, Token* name) {
     return makeIdentifier(compiler, OBJ_VAL(copyStringPerma(compiler->vm, start, length)));
 }
 
+static int globalSlot(Compiler* compiler, IDMap* indexes, Token* name) {
+    const char* start = name->start[0] != '`' ? name->start : name->start + 1;
+    int length = name->start[0] != '`' ? name->length : name->length - 2;
+    int slot;
+    if (!idMapGet(indexes, copyStringPerma(compiler->vm, start, length), &slot) || slot > UINT8_MAX) return -1;
+    return slot;
+}
+
 static ObjString* identifierName(Compiler* compiler, uint8_t arg) {
     return AS_STRING(currentChunk(compiler)->identifiers.values[arg]);
 }
@@ -396,6 +425,7 @@ static int addLocal(Compiler* compiler, Token name) {
     local->depth = -1;
     local->isCaptured = false;
     local->isMutable = true;
+    if (compiler->localCount > compiler->function->maxLocals) compiler->function->maxLocals = compiler->localCount;
     return compiler->localCount - 1;
 }
 
@@ -501,8 +531,18 @@ static void getVariable(Compiler* compiler, SymbolItem* item) {
         case SYMBOL_CATEGORY_UPVALUE:
             emitBytes(compiler, OP_GET_UPVALUE, (uint8_t)findUpvalue(compiler, &item->token));
             break;
-        default:
-            emitBytes(compiler, OP_GET_GLOBAL, (uint8_t)identifierConstant(compiler, &item->token));
+        default: {
+            ObjModule* module = compiler->vm->currentModule;
+            int slot = globalSlot(compiler, &module->valIndexes, &item->token);
+            if (slot != -1) {
+                emitBytes(compiler, OP_GET_GLOBAL_VAL, (uint8_t)slot);
+                break;
+            }
+
+            slot = globalSlot(compiler, &module->varIndexes, &item->token);
+            if (slot != -1) emitBytes(compiler, OP_GET_GLOBAL_VAR, (uint8_t)slot);
+            else emitBytes(compiler, OP_GET_GLOBAL, (uint8_t)identifierConstant(compiler, &item->token));
+        }
     }
 }
 
@@ -538,7 +578,8 @@ static void function(Compiler* enclosing, CompileType type, Ast* ast, bool isAsy
     parameters(&compiler, astGetChild(ast, 0));
     block(&compiler, astGetChild(ast, 1));
     ObjFunction* function = endCompiler(&compiler);
-    emitBytes(enclosing, OP_CLOSURE, makeIdentifier(enclosing, OBJ_VAL(function)));
+    OpCode opCode = (ast->modifier.isBorrowed && function->upvalueCount > 0) ? OP_BORROW_CLOSURE : OP_CLOSURE;
+    emitBytes(enclosing, opCode, makeIdentifier(enclosing, OBJ_VAL(function)));
 
     for (int i = 0; i < function->upvalueCount; i++) {
         emitByte(enclosing, compiler.upvalues[i].isLocal ? 1 : 0);
@@ -642,8 +683,12 @@ static void compileAssign(Compiler* compiler, Ast* ast) {
             setOp = OP_SET_UPVALUE;
             break;
         default:
-            arg = identifierConstant(compiler, &ast->token);
-            setOp = OP_SET_GLOBAL;
+            arg = globalSlot(compiler, &compiler->vm->currentModule->varIndexes, &ast->token);
+            if (arg != -1) setOp = OP_SET_GLOBAL_VAR;
+            else {
+                arg = identifierConstant(compiler, &ast->token);
+                setOp = OP_SET_GLOBAL;
+            }
     }
 
     compileChild(compiler, ast, 0);
@@ -711,28 +756,20 @@ static void compileGrouping(Compiler* compiler, Ast* ast) {
 
 static void compileInterpolation(Compiler* compiler, Ast* ast) {
     Ast* exprs = astGetChild(ast, 0);
-    int count = 0;
-    while (count < exprs->children->count) {
-        bool concatenate = false;
-        bool isString = false;
-        Ast* expr = astGetChild(exprs, count);
-
-        if (expr->kind == AST_EXPR_LITERAL && expr->token.type == TOKEN_STRING) {
-            compileChild(compiler, exprs, count);
-            if (count > 0) emitByte(compiler, OP_ADD);
-            concatenate = true;
-            isString = true;
-            count++;            
-            if (count >= exprs->children->count) break;
+    int partCount = 0;
+    for (int i = 0; i < exprs->children->count; i++) {
+        Ast* expr = astGetChild(exprs, i);
+        compileChild(compiler, exprs, i);
+        if (expr->kind != AST_EXPR_LITERAL || expr->token.type != TOKEN_STRING) {
+            invokeMethod(compiler, 0, "toString", 8);
         }
 
-        compileChild(compiler, exprs, count);
-        invokeMethod(compiler, 0, "toString", 8);
-        if (concatenate || (count >= 1 && !isString)) {
-            emitByte(compiler, OP_ADD);
+        if (++partCount == UINT8_MAX) {
+            emitBytes(compiler, OP_BUILD_STRING, partCount);
+            partCount = 1;
         }
-        count++;
     }
+    if (partCount > 1) emitBytes(compiler, OP_BUILD_STRING, partCount);
 }
 
 static void compileInvoke(Compiler* compiler, Ast* ast) {
@@ -1023,6 +1060,9 @@ static void compileForStatement(Compiler* compiler, Ast* ast) {
     beginScope(compiler);
     Token indexToken, valueToken;
     Ast* decl = astGetChild(ast, 0);
+    Ast* expr = astGetChild(ast, 1);
+    bool isRange = (expr->kind == AST_EXPR_BINARY && expr->token.type == TOKEN_DOT_DOT);
+    int hiddenCount = isRange ? 3 : 2;
 
     if (astNumChild(decl) > 1) {
         indexToken = decl->children->elements[0]->token;
@@ -1033,12 +1073,33 @@ static void compileForStatement(Compiler* compiler, Ast* ast) {
         valueToken = decl->children->elements[0]->token;
     }
 
-    compileChild(compiler, ast, 1);
-    if (compiler->localCount + 3 > UINT8_MAX) {
+    if (compiler->localCount + hiddenCount + 1 > UINT8_MAX) {
         compileError(compiler, "for loop can only contain up to 252 variables.");
     }
 
-    int collectionSlot = addLocal(compiler, syntheticToken("collection "));
+    int collectionSlot;
+    if (isRange) {
+        compileChild(compiler, expr, 0);
+        collectionSlot = addLocal(compiler, syntheticToken("collection "));
+        compileChild(compiler, expr, 1);
+        int limitSlot = addLocal(compiler, syntheticToken("limit "));
+
+        int boundsJump = emitJump(compiler, OP_JUMP_IF_INT_BOUNDS);
+        getLocal(compiler, collectionSlot);
+        getLocal(compiler, limitSlot);
+        emitByte(compiler, OP_RANGE);
+        setLocal(compiler, collectionSlot);
+        emitByte(compiler, OP_POP);
+        emitByte(compiler, OP_NIL);
+        setLocal(compiler, limitSlot);
+        emitByte(compiler, OP_POP);
+        patchJump(compiler, boundsJump);
+    }
+    else {
+        compileChild(compiler, ast, 1);
+        collectionSlot = addLocal(compiler, syntheticToken("collection "));
+    }
+
     emitByte(compiler, OP_NIL);
     int indexSlot = addLocal(compiler, indexToken);
     markInitialized(compiler, true);
@@ -1046,9 +1107,10 @@ static void compileForStatement(Compiler* compiler, Ast* ast) {
     LoopCompiler* outerLoop = compiler->currentLoop;
     LoopCompiler innerLoop;
     initLoopCompiler(compiler, &innerLoop);
+    int iterateJump = emitIterate(compiler, isRange ? OP_FOR_ITER_RANGE : OP_FOR_ITER, collectionSlot, indexSlot);
+
     getLocal(compiler, collectionSlot);
     getLocal(compiler, indexSlot);
-
     invokeMethod(compiler, 1, "next", 4);
     setLocal(compiler, indexSlot);
     emitByte(compiler, OP_POP);
@@ -1057,6 +1119,7 @@ static void compileForStatement(Compiler* compiler, Ast* ast) {
     getLocal(compiler, collectionSlot);
     getLocal(compiler, indexSlot);
     invokeMethod(compiler, 1, "nextValue", 9);
+    patchIterate(compiler, iterateJump + 2, iterateJump + 4);
 
     beginScope(compiler);
     int valueSlot = addLocal(compiler, valueToken);
@@ -1067,11 +1130,13 @@ static void compileForStatement(Compiler* compiler, Ast* ast) {
 
     emitLoop(compiler);
     patchJump(compiler, compiler->currentLoop->exitJump);
+    patchIterate(compiler, iterateJump, iterateJump + 4);
     endLoopCompiler(compiler);
-    emitByte(compiler, OP_POP);
-    emitByte(compiler, OP_POP);
+    for (int i = 0; i < hiddenCount; i++) {
+        emitByte(compiler, OP_POP);
+    }
 
-    compiler->localCount -= 2;
+    compiler->localCount -= hiddenCount;
     compiler->currentLoop = outerLoop;
     endScope(compiler);
 }
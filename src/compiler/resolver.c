@@ -632,6 +632,13 @@ static void resolveInterpolation(Resolver* resolver, Ast* ast) {
 static void resolveInvoke(Resolver* resolver, Ast* ast) {
     resolveChild(resolver, ast, 0);
     resolveChild(resolver, ast, 1);
+
+    // A function literal passed last is handed straight to the callee, the VM decides whether it may escape.
+    Ast* args = astGetChild(ast, 1);
+    int argCount = astNumChild(args);
+    if (argCount == 0) return;
+    Ast* lastArg = astGetChild(args, argCount - 1);
+    if (lastArg->kind == AST_EXPR_FUNCTION && !lastArg->modifier.isAsync) lastArg->modifier.isBorrowed = true;
 }
 
 static void resolveLiteral(Resolver* resolver, Ast* ast) {
@@ -67,7 +67,7 @@ static bool dictsEqual(ObjDictionary* aDict, ObjDictionary* dict2) {
         if (IS_UNDEFINED(entry->key)) continue;
         Value bValue;
         bool keyExists = dictGet(dict2, entry->key, &bValue);
-        if (!keyExists || entry->value != bValue) {
+        if (!keyExists || !valuesIdentical(entry->value, bValue)) {
             return false;
         }
     }
@@ -77,7 +77,7 @@ static bool dictsEqual(ObjDictionary* aDict, ObjDictionary* dict2) {
         if (IS_UNDEFINED(entry->key)) continue;
         Value aValue;
         bool keyExists = dictGet(aDict, entry->key, &aValue);
-        if (!keyExists || entry->value != aValue) {
+        if (!keyExists || !valuesIdentical(entry->value, aValue)) {
             return false;
         }
     }
@@ -85,29 +85,6 @@ static bool dictsEqual(ObjDictionary* aDict, ObjDictionary* dict2) {
     return true;
 }
 
-static int dictFindIndex(ObjDictionary* dict, Value key) {
-    uint32_t hash = hashValue(key);
-    uint32_t index = hash & (dict->capacity - 1);
-    ObjEntry* tombstone = NULL;
-
-    for (;;) {
-        ObjEntry* entry = &dict->entries[index];
-        if (IS_UNDEFINED(entry->key)) {
-            if (IS_NIL(entry->value)) {
-                return -1;
-            }
-            else {
-                if (tombstone == NULL) tombstone = entry;
-            }
-        }
-        else if (entry->key == key) {
-            return index;
-        }
-
-        index = (index + 1) & (dict->capacity - 1);
-    }
-}
-
 static ObjString* dictToString(VM* vm, ObjDictionary* dict) {
     if (dict->count == 0) return copyStringPerma(vm, "[]", 2);
     else {
@@ -168,9 +145,13 @@ static bool linkAddBefore(VM* vm, ObjInstance* linkedList, Value element, ObjNod
         ObjNode* pred = succ->prev;
         ObjNode* new = newNode(vm, element, pred, succ);
         push(vm, OBJ_VAL(new));
+        PROCESS_WRITE_BARRIER((Obj*)succ, OBJ_VAL(new));
         succ->prev = new;
         if (pred == NULL) setObjProperty(vm, linkedList, "first", OBJ_VAL(new));
-        else pred->next = new;
+        else {
+            PROCESS_WRITE_BARRIER((Obj*)pred, OBJ_VAL(new));
+            pred->next = new;
+        }
         pop(vm);
         collectionLengthIncrement(vm, linkedList);
         return true;
@@ -184,7 +165,10 @@ static void linkAddFirst(VM* vm, ObjInstance* linkedList, Value element) {
     push(vm, OBJ_VAL(new));
     setObjProperty(vm, linkedList, "first", OBJ_VAL(new));
     if (first == NULL) setObjProperty(vm, linkedList, "last", OBJ_VAL(new));
-    else first->prev = new;
+    else {
+        PROCESS_WRITE_BARRIER((Obj*)first, OBJ_VAL(new));
+        first->prev = new;
+    }
     pop(vm);
     collectionLengthIncrement(vm, linkedList);
 }
@@ -196,7 +180,10 @@ static void linkAddLast(VM* vm, ObjInstance* linkedList, Value element) {
     push(vm, OBJ_VAL(new));
     setObjProperty(vm, linkedList, "last", OBJ_VAL(new));
     if (last == NULL) setObjProperty(vm, linkedList, "first", OBJ_VAL(new));
-    else last->next = new;
+    else {
+        PROCESS_WRITE_BARRIER((Obj*)last, OBJ_VAL(new));
+        last->next = new;
+    }
     pop(vm);
     collectionLengthIncrement(vm, linkedList);
 }
@@ -415,6 +402,7 @@ LOX_METHOD(Array, __init__) {
 
 LOX_METHOD(Array, add) {
     ASSERT_ARG_COUNT("Array::add(element)", 1);
+    PROCESS_WRITE_BARRIER(AS_OBJ(receiver), args[0]);
     valueArrayWrite(vm, &AS_ARRAY(receiver)->elements, args[0]);
     RETURN_OBJ(receiver);
 }
@@ -422,6 +410,7 @@ LOX_METHOD(Array, add) {
 LOX_METHOD(Array, addAll) {
     ASSERT_ARG_COUNT("Array::addAll(array)", 1);
     ASSERT_ARG_TYPE("Array::addAll(array)", 0, Array);
+    if (AS_OBJ(receiver)->generation > GC_GENERATION_TYPE_EDEN) addToRememberedSet(vm, AS_OBJ(receiver), GC_GENERATION_TYPE_EDEN);
     valueArrayAddAll(vm, &AS_ARRAY(args[0])->elements, &AS_ARRAY(receiver)->elements);
     RETURN_OBJ(receiver);
 }
@@ -438,20 +427,31 @@ LOX_METHOD(Array, clone) {
     RETURN_OBJ(arrayCopy(vm, self->elements, 0, self->elements.count));
 }
 
+LOX_CONTINUATION(Array, collect) {
+    ObjArray* self = AS_ARRAY(slots[0]);
+    ObjArray* collected = AS_ARRAY(slots[3]);
+    int index = AS_INT(slots[2]);
+
+    while (true) {
+        if (index >= 0) {
+            push(vm, result);
+            PROCESS_WRITE_BARRIER((Obj*)collected, result);
+            valueArrayWrite(vm, &collected->elements, result);
+            pop(vm);
+        }
+        if (++index >= self->elements.count) RETURN_OBJ(collected);
+        slots[2] = INT_VAL(index);
+        if (CALL_CONTINUATION(Array, collect, 1, self->elements.values[index])) RETURN_NIL;
+        result = pop(vm);
+    }
+}
+
 LOX_METHOD(Array, collect) {
     ASSERT_ARG_COUNT("Array::collect(closure)", 1);
     ASSERT_ARG_TCALLABLE("Array::collect(closure)", 0);
-    ObjArray* self = AS_ARRAY(receiver);
-    Value closure = args[0];
-
-    ObjArray* collected = newArray(vm);
-    push(vm, OBJ_VAL(collected));
-    for (int i = 0; i < self->elements.count; i++) {
-        Value result = callReentrantMethod(vm, receiver, closure, self->elements.values[i]);
-        valueArrayWrite(vm, &collected->elements, result);
-    }
-    pop(vm);
-    RETURN_OBJ(collected);
+    push(vm, INT_VAL(-1));
+    push(vm, OBJ_VAL(newArray(vm)));
+    RETURN_CONTINUATION(Array, collect);
 }
 
 LOX_METHOD(Array, contains) {
@@ -459,15 +459,34 @@ LOX_METHOD(Array, contains) {
     RETURN_BOOL(valueArrayFirstIndex(vm, &AS_ARRAY(receiver)->elements, args[0]) != -1);
 }
 
+LOX_CONTINUATION(Array, detect) {
+    ObjArray* self = AS_ARRAY(slots[0]);
+    int index = AS_INT(slots[2]);
+
+    while (true) {
+        if (index >= 0 && !isFalsey(result)) RETURN_VAL(self->elements.values[index]);
+        if (++index >= self->elements.count) RETURN_NIL;
+        slots[2] = INT_VAL(index);
+        if (CALL_CONTINUATION(Array, detect, 1, self->elements.values[index])) RETURN_NIL;
+        result = pop(vm);
+    }
+}
+
 LOX_METHOD(Array, detect) {
     ASSERT_ARG_COUNT("Array::detect(closure)", 1);
     ASSERT_ARG_TCALLABLE("Array::detect(closure)", 0);
-    ObjArray* self = AS_ARRAY(receiver);
-    Value closure = args[0];
+    push(vm, INT_VAL(-1));
+    RETURN_CONTINUATION(Array, detect);
+}
+
+LOX_CONTINUATION(Array, each) {
+    ObjArray* self = AS_ARRAY(slots[0]);
+    int index = AS_INT(slots[2]);
 
-    for (int i = 0; i < self->elements.count; i++) {
-        Value result = callReentrantMethod(vm, receiver, closure, self->elements.values[i]);
-        if (!isFalsey(result)) RETURN_VAL(self->elements.values[i]);
+    while (++index < self->elements.count) {
+        slots[2] = INT_VAL(index);
+        if (CALL_CONTINUATION(Array, each, 1, self->elements.values[index])) RETURN_NIL;
+        pop(vm);
     }
     RETURN_NIL;
 }
@@ -475,11 +494,18 @@ LOX_METHOD(Array, detect) {
 LOX_METHOD(Array, each) {
     ASSERT_ARG_COUNT("Array::each(closure)", 1);
     ASSERT_ARG_TCALLABLE("Array::each(closure)", 0);
-    ObjArray* self = AS_ARRAY(receiver);
-    Value closure = args[0];
+    push(vm, INT_VAL(-1));
+    RETURN_CONTINUATION(Array, each);
+}
+
+LOX_CONTINUATION(Array, eachIndex) {
+    ObjArray* self = AS_ARRAY(slots[0]);
+    int index = AS_INT(slots[2]);
 
-    for (int i = 0; i < self->elements.count; i++) {
-        callReentrantMethod(vm, receiver, closure, self->elements.values[i]);
+    while (++index < self->elements.count) {
+        slots[2] = INT_VAL(index);
+        if (CALL_CONTINUATION(Array, eachIndex, 2, INT_VAL(index), self->elements.values[index])) RETURN_NIL;
+        pop(vm);
     }
     RETURN_NIL;
 }
@@ -487,13 +513,8 @@ LOX_METHOD(Array, each) {
 LOX_METHOD(Array, eachIndex) { 
     ASSERT_ARG_COUNT("Array::eachIndex(closure)", 1);
     ASSERT_ARG_TCALLABLE("Array::eachIndex(closure)", 0);
-    ObjArray* self = AS_ARRAY(receiver);
-    Value closure = args[0];
-    
-    for (int i = 0; i < self->elements.count; i++) {
-        callReentrantMethod(vm, receiver, closure, INT_VAL(i), self->elements.values[i]);
-    }
-    RETURN_NIL;
+    push(vm, INT_VAL(-1));
+    RETURN_CONTINUATION(Array, eachIndex);
 }
 
 LOX_METHOD(Array, equals) {
@@ -507,6 +528,7 @@ LOX_METHOD(Array, fill) {
     ASSERT_ARG_TYPE("Array::fill(num, value)", 0, Int);
     ObjArray* array = AS_ARRAY(receiver);
     int num = AS_INT(args[0]);
+    PROCESS_WRITE_BARRIER((Obj*)array, args[1]);
     for (int i = 0; i < num; i++) {
         valueArrayWrite(vm, &array->elements, args[1]);
     }
@@ -535,6 +557,7 @@ LOX_METHOD(Array, insertAt) {
     ObjArray* self = AS_ARRAY(receiver);
     int index = AS_INT(args[0]);
     ASSERT_INDEX_WITHIN_BOUNDS("Array::insertAt(index, element)", index, 0, self->elements.count, 0);
+    PROCESS_WRITE_BARRIER((Obj*)self, args[1]);
     valueArrayInsert(vm, &self->elements, index, args[1]);
     RETURN_VAL(args[1]);
 }
@@ -583,24 +606,34 @@ LOX_METHOD(Array, putAt) {
     ASSERT_ARG_COUNT("Array::putAt(index, element)", 2);
     ASSERT_ARG_TYPE("Array::putAt(index, element)", 0, Int);
     ObjArray* self = AS_ARRAY(receiver);
+    PROCESS_WRITE_BARRIER((Obj*)self, args[1]);
     valueArrayPut(vm, &self->elements, AS_INT(args[0]), args[1]);
     RETURN_OBJ(receiver);
 }
 
+LOX_CONTINUATION(Array, reject) {
+    ObjArray* self = AS_ARRAY(slots[0]);
+    ObjArray* rejected = AS_ARRAY(slots[3]);
+    int index = AS_INT(slots[2]);
+
+    while (true) {
+        if (index >= 0 && isFalsey(result)) {
+            PROCESS_WRITE_BARRIER((Obj*)rejected, self->elements.values[index]);
+            valueArrayWrite(vm, &rejected->elements, self->elements.values[index]);
+        }
+        if (++index >= self->elements.count) RETURN_OBJ(rejected);
+        slots[2] = INT_VAL(index);
+        if (CALL_CONTINUATION(Array, reject, 1, self->elements.values[index])) RETURN_NIL;
+        result = pop(vm);
+    }
+}
+
 LOX_METHOD(Array, reject) {
     ASSERT_ARG_COUNT("Array::reject(closure)", 1);
     ASSERT_ARG_TCALLABLE("Array::reject(closure)", 0);
-    ObjArray* self = AS_ARRAY(receiver);
-    Value closure = args[0];
-
-    ObjArray* rejected = newArray(vm);
-    push(vm, OBJ_VAL(rejected));
-    for (int i = 0; i < self->elements.count; i++) {
-        Value result = callReentrantMethod(vm, receiver, closure, self->elements.values[i]);
-        if (isFalsey(result)) valueArrayWrite(vm, &rejected->elements, self->elements.values[i]);
-    }
-    pop(vm);
-    RETURN_OBJ(rejected);
+    push(vm, INT_VAL(-1));
+    push(vm, OBJ_VAL(newArray(vm)));
+    RETURN_CONTINUATION(Array, reject);
 }
 
 LOX_METHOD(Array, remove) {
@@ -622,20 +655,29 @@ LOX_METHOD(Array, removeAt) {
     RETURN_VAL(element);
 }
 
+LOX_CONTINUATION(Array, select) {
+    ObjArray* self = AS_ARRAY(slots[0]);
+    ObjArray* selected = AS_ARRAY(slots[3]);
+    int index = AS_INT(slots[2]);
+
+    while (true) {
+        if (index >= 0 && !isFalsey(result)) {
+            PROCESS_WRITE_BARRIER((Obj*)selected, self->elements.values[index]);
+            valueArrayWrite(vm, &selected->elements, self->elements.values[index]);
+        }
+        if (++index >= self->elements.count) RETURN_OBJ(selected);
+        slots[2] = INT_VAL(index);
+        if (CALL_CONTINUATION(Array, select, 1, self->elements.values[index])) RETURN_NIL;
+        result = pop(vm);
+    }
+}
+
 LOX_METHOD(Array, select) {
     ASSERT_ARG_COUNT("Array::select(closure)", 1);
     ASSERT_ARG_TCALLABLE("Array::select(closure)", 0);
-    ObjArray* self = AS_ARRAY(receiver);
-    Value closure = args[0];
-
-    ObjArray* selected = newArray(vm);
-    push(vm, OBJ_VAL(selected));
-    for (int i = 0; i < self->elements.count; i++) {
-        Value result = callReentrantMethod(vm, receiver, closure, self->elements.values[i]);
-        if (!isFalsey(result)) valueArrayWrite(vm, &selected->elements, self->elements.values[i]);
-    }
-    pop(vm);
-    RETURN_OBJ(selected);
+    push(vm, INT_VAL(-1));
+    push(vm, OBJ_VAL(newArray(vm)));
+    RETURN_CONTINUATION(Array, select);
 }
 
 LOX_METHOD(Array, slice) {
@@ -670,6 +712,7 @@ LOX_METHOD(Array, __setSubscript__) {
     ObjArray* self = AS_ARRAY(receiver);
     int index = AS_INT(args[0]);
     ASSERT_INDEX_WITHIN_BOUNDS("Array::[]=(index, element)", index, 0, self->elements.count, 0);
+    PROCESS_WRITE_BARRIER((Obj*)self, args[1]);
     self->elements.values[index] = args[1];
     if (index == self->elements.count) self->elements.count++;
     RETURN_OBJ(receiver);
@@ -864,25 +907,36 @@ LOX_METHOD(Dictionary, clone) {
     RETURN_OBJ(dictCopy(vm, AS_DICTIONARY(receiver)));
 }
 
+LOX_CONTINUATION(Dictionary, collect) {
+    ObjDictionary* collected = AS_DICTIONARY(slots[6]);
+    Value key = slots[4];
+
+    while (true) {
+        if (key != NIL_VAL) {
+            push(vm, result);
+            PROCESS_WRITE_BARRIER((Obj*)collected, key);
+            PROCESS_WRITE_BARRIER((Obj*)collected, result);
+            dictSet(vm, collected, key, result);
+            pop(vm);
+        }
+        key = callReentrantMethod(vm, slots[0], slots[2], key);
+        if (key == NIL_VAL) RETURN_OBJ(collected);
+        slots[4] = key;
+        slots[5] = callReentrantMethod(vm, slots[0], slots[3], key);
+        if (CALL_CONTINUATION(Dictionary, collect, 2, key, slots[5])) RETURN_NIL;
+        result = pop(vm);
+    }
+}
+
 LOX_METHOD(Dictionary, collect) {
     ASSERT_ARG_COUNT("Dictionary::collect(closure)", 1);
     ASSERT_ARG_TCALLABLE("Dictionary::collect(closure)", 0);
-    ObjDictionary* self = AS_DICTIONARY(receiver);
-    Value closure = args[0];
-    Value nextMethod = getObjMethod(vm, receiver, "next");
-    Value nextValueMethod = getObjMethod(vm, receiver, "nextValue");
-    Value key = callReentrantMethod(vm, receiver, nextMethod, NIL_VAL);
-
-    ObjDictionary* collected = newDictionary(vm);
-    push(vm, OBJ_VAL(collected));
-    while (key != NIL_VAL) {
-        Value value = callReentrantMethod(vm, receiver, nextValueMethod, key);
-        Value result = callReentrantMethod(vm, receiver, closure, key, value);
-        dictSet(vm, collected, key, result);
-        key = callReentrantMethod(vm, receiver, nextMethod, key);
-    }
-    pop(vm);
-    RETURN_OBJ(collected);
+    push(vm, getObjMethod(vm, receiver, "next"));
+    push(vm, getObjMethod(vm, receiver, "nextValue"));
+    push(vm, NIL_VAL);
+    push(vm, NIL_VAL);
+    push(vm, OBJ_VAL(newDictionary(vm)));
+    RETURN_CONTINUATION(Dictionary, collect);
 }
 
 LOX_METHOD(Dictionary, containsKey) {
@@ -895,70 +949,97 @@ LOX_METHOD(Dictionary, containsValue) {
     RETURN_BOOL(dictContainsValue(AS_DICTIONARY(receiver), args[0]));
 }
 
+LOX_CONTINUATION(Dictionary, detect) {
+    Value key = slots[4];
+
+    while (true) {
+        if (key != NIL_VAL && !isFalsey(result)) RETURN_VAL(slots[5]);
+        key = callReentrantMethod(vm, slots[0], slots[2], key);
+        if (key == NIL_VAL) RETURN_NIL;
+        slots[4] = key;
+        slots[5] = callReentrantMethod(vm, slots[0], slots[3], key);
+        if (CALL_CONTINUATION(Dictionary, detect, 2, key, slots[5])) RETURN_NIL;
+        result = pop(vm);
+    }
+}
+
 LOX_METHOD(Dictionary, detect) {
     ASSERT_ARG_COUNT("Dictionary::detect(closure)", 1);
     ASSERT_ARG_TCALLABLE("Dictionary::detect(closure)", 0);
-    ObjDictionary* self = AS_DICTIONARY(receiver);
-    Value closure = args[0];
-    Value nextMethod = getObjMethod(vm, receiver, "next");
-    Value nextValueMethod = getObjMethod(vm, receiver, "nextValue");
-    Value key = callReentrantMethod(vm, receiver, nextMethod, NIL_VAL);
-
-    while (key != NIL_VAL) {
-        Value value = callReentrantMethod(vm, receiver, nextValueMethod, key);
-        Value result = callReentrantMethod(vm, receiver, closure, key, value);
-        if (!isFalsey(result)) RETURN_VAL(value);
-        key = callReentrantMethod(vm, receiver, nextMethod, key);
+    push(vm, getObjMethod(vm, receiver, "next"));
+    push(vm, getObjMethod(vm, receiver, "nextValue"));
+    push(vm, NIL_VAL);
+    push(vm, NIL_VAL);
+    RETURN_CONTINUATION(Dictionary, detect);
+}
+
+LOX_CONTINUATION(Dictionary, each) {
+    Value key = slots[4];
+
+    while (true) {
+        key = callReentrantMethod(vm, slots[0], slots[2], key);
+        if (key == NIL_VAL) RETURN_NIL;
+        slots[4] = key;
+        slots[5] = callReentrantMethod(vm, slots[0], slots[3], key);
+        if (CALL_CONTINUATION(Dictionary, each, 2, key, slots[5])) RETURN_NIL;
+        pop(vm);
     }
-    RETURN_NIL;
 }
 
 LOX_METHOD(Dictionary, each) {
     ASSERT_ARG_COUNT("Dictionary::each(closure)", 1);
     ASSERT_ARG_TCALLABLE("Dictionary::each(closure)", 0);
-    Value closure = args[0];
-    Value nextMethod = getObjMethod(vm, receiver, "next");
-    Value nextValueMethod = getObjMethod(vm, receiver, "nextValue");
-    Value key = callReentrantMethod(vm, receiver, nextMethod, NIL_VAL);
-
-    while (key != NIL_VAL) {
-        Value value = callReentrantMethod(vm, receiver, nextValueMethod, key);
-        callReentrantMethod(vm, receiver, closure, key, value);
-        key = callReentrantMethod(vm, receiver, nextMethod, key);
+    push(vm, getObjMethod(vm, receiver, "next"));
+    push(vm, getObjMethod(vm, receiver, "nextValue"));
+    push(vm, NIL_VAL);
+    push(vm, NIL_VAL);
+    RETURN_CONTINUATION(Dictionary, each);
+}
+
+LOX_CONTINUATION(Dictionary, eachKey) {
+    Value key = slots[4];
+
+    while (true) {
+        key = callReentrantMethod(vm, slots[0], slots[2], key);
+        if (key == NIL_VAL) RETURN_NIL;
+        slots[4] = key;
+        slots[5] = callReentrantMethod(vm, slots[0], slots[3], key);
+        if (CALL_CONTINUATION(Dictionary, eachKey, 1, key)) RETURN_NIL;
+        pop(vm);
     }
-    RETURN_NIL;
 }
 
 LOX_METHOD(Dictionary, eachKey) {
     ASSERT_ARG_COUNT("Dictionary::each(closure)", 1);
     ASSERT_ARG_TCALLABLE("Dictionary::each(closure)", 0);
-    Value closure = args[0];
-    Value nextMethod = getObjMethod(vm, receiver, "next");
-    Value nextValueMethod = getObjMethod(vm, receiver, "nextValue");
-    Value key = callReentrantMethod(vm, receiver, nextMethod, NIL_VAL);
-
-    while (key != NIL_VAL) {
-        callReentrantMethod(vm, receiver, nextValueMethod, key);
-        callReentrantMethod(vm, receiver, closure, key);
-        key = callReentrantMethod(vm, receiver, nextMethod, key);
+    push(vm, getObjMethod(vm, receiver, "next"));
+    push(vm, getObjMethod(vm, receiver, "nextValue"));
+    push(vm, NIL_VAL);
+    push(vm, NIL_VAL);
+    RETURN_CONTINUATION(Dictionary, eachKey);
+}
+
+LOX_CONTINUATION(Dictionary, eachValue) {
+    Value key = slots[4];
+
+    while (true) {
+        key = callReentrantMethod(vm, slots[0], slots[2], key);
+        if (key == NIL_VAL) RETURN_NIL;
+        slots[4] = key;
+        slots[5] = callReentrantMethod(vm, slots[0], slots[3], key);
+        if (CALL_CONTINUATION(Dictionary, eachValue, 1, slots[5])) RETURN_NIL;
+        pop(vm);
     }
-    RETURN_NIL;
 }
 
 LOX_METHOD(Dictionary, eachValue) {
     ASSERT_ARG_COUNT("Dictionary::each(closure)", 1);
     ASSERT_ARG_TCALLABLE("Dictionary::each(closure)", 0);
-    Value closure = args[0];
-    Value nextMethod = getObjMethod(vm, receiver, "next");
-    Value nextValueMethod = getObjMethod(vm, receiver, "nextValue");
-    Value key = callReentrantMethod(vm, receiver, nextMethod, NIL_VAL);
-
-    while (key != NIL_VAL) {
-        Value value = callReentrantMethod(vm, receiver, nextValueMethod, key);
-        callReentrantMethod(vm, receiver, closure, value);
-        key = callReentrantMethod(vm, receiver, nextMethod, key);
-    }
-    RETURN_NIL;
+    push(vm, getObjMethod(vm, receiver, "next"));
+    push(vm, getObjMethod(vm, receiver, "nextValue"));
+    push(vm, NIL_VAL);
+    push(vm, NIL_VAL);
+    RETURN_CONTINUATION(Dictionary, eachValue);
 }
 
 LOX_METHOD(Dictionary, entrySet) {
@@ -1048,35 +1129,49 @@ LOX_METHOD(Dictionary, nextValue) {
 LOX_METHOD(Dictionary, putAll) {
     ASSERT_ARG_COUNT("Dictionary::putAll(dictionary)", 1);
     ASSERT_ARG_TYPE("Dictionary::putAll(dictionary)", 0, Dictionary);
+    if (AS_OBJ(receiver)->generation > GC_GENERATION_TYPE_EDEN) addToRememberedSet(vm, AS_OBJ(receiver), GC_GENERATION_TYPE_EDEN);
     dictAddAll(vm, AS_DICTIONARY(args[0]), AS_DICTIONARY(receiver));
     RETURN_OBJ(receiver);
 }
 
 LOX_METHOD(Dictionary, putAt) {
     ASSERT_ARG_COUNT("Dictionary::putAt(key, value)", 2);
-    if(!IS_NIL(args[0])) dictSet(vm, AS_DICTIONARY(receiver), args[0], args[1]);
+    if (!IS_NIL(args[0])) {
+        PROCESS_WRITE_BARRIER(AS_OBJ(receiver), args[0]);
+        PROCESS_WRITE_BARRIER(AS_OBJ(receiver), args[1]);
+        dictSet(vm, AS_DICTIONARY(receiver), args[0], args[1]);
+    }
     RETURN_OBJ(receiver);
 }
 
+LOX_CONTINUATION(Dictionary, reject) {
+    ObjDictionary* rejected = AS_DICTIONARY(slots[6]);
+    Value key = slots[4];
+
+    while (true) {
+        if (key != NIL_VAL && isFalsey(result)) {
+            PROCESS_WRITE_BARRIER((Obj*)rejected, key);
+            PROCESS_WRITE_BARRIER((Obj*)rejected, slots[5]);
+            dictSet(vm, rejected, key, slots[5]);
+        }
+        key = callReentrantMethod(vm, slots[0], slots[2], key);
+        if (key == NIL_VAL) RETURN_OBJ(rejected);
+        slots[4] = key;
+        slots[5] = callReentrantMethod(vm, slots[0], slots[3], key);
+        if (CALL_CONTINUATION(Dictionary, reject, 2, key, slots[5])) RETURN_NIL;
+        result = pop(vm);
+    }
+}
+
 LOX_METHOD(Dictionary, reject) {
     ASSERT_ARG_COUNT("Dictionary::reject(closure)", 1);
     ASSERT_ARG_TCALLABLE("Dictionary::reject(closure)", 0);
-    ObjDictionary* self = AS_DICTIONARY(receiver);
-    Value closure = args[0];
-    Value nextMethod = getObjMethod(vm, receiver, "next");
-    Value nextValueMethod = getObjMethod(vm, receiver, "nextValue");
-    Value key = callReentrantMethod(vm, receiver, nextMethod, NIL_VAL);
-
-    ObjDictionary* rejected = newDictionary(vm);
-    push(vm, OBJ_VAL(rejected));
-    while (key != NIL_VAL) {
-        Value value = callReentrantMethod(vm, receiver, nextValueMethod, key);
-        Value result = callReentrantMethod(vm, receiver, closure, key, value);
-        if (isFalsey(result)) dictSet(vm, rejected, key, value);
-        key = callReentrantMethod(vm, receiver, nextMethod, key);
-    }
-    pop(vm);
-    RETURN_OBJ(rejected);
+    push(vm, getObjMethod(vm, receiver, "next"));
+    push(vm, getObjMethod(vm, receiver, "nextValue"));
+    push(vm, NIL_VAL);
+    push(vm, NIL_VAL);
+    push(vm, OBJ_VAL(newDictionary(vm)));
+    RETURN_CONTINUATION(Dictionary, reject);
 }
 
 LOX_METHOD(Dictionary, removeAt) {
@@ -1091,25 +1186,34 @@ LOX_METHOD(Dictionary, removeAt) {
     RETURN_VAL(value);
 }
 
+LOX_CONTINUATION(Dictionary, select) {
+    ObjDictionary* selected = AS_DICTIONARY(slots[6]);
+    Value key = slots[4];
+
+    while (true) {
+        if (key != NIL_VAL && !isFalsey(result)) {
+            PROCESS_WRITE_BARRIER((Obj*)selected, key);
+            PROCESS_WRITE_BARRIER((Obj*)selected, slots[5]);
+            dictSet(vm, selected, key, slots[5]);
+        }
+        key = callReentrantMethod(vm, slots[0], slots[2], key);
+        if (key == NIL_VAL) RETURN_OBJ(selected);
+        slots[4] = key;
+        slots[5] = callReentrantMethod(vm, slots[0], slots[3], key);
+        if (CALL_CONTINUATION(Dictionary, select, 2, key, slots[5])) RETURN_NIL;
+        result = pop(vm);
+    }
+}
+
 LOX_METHOD(Dictionary, select) {
     ASSERT_ARG_COUNT("Dictionary::select(closure)", 1);
     ASSERT_ARG_TCALLABLE("Dictionary::select(closure)", 0);
-    ObjDictionary* self = AS_DICTIONARY(receiver);
-    Value closure = args[0];
-    Value nextMethod = getObjMethod(vm, receiver, "next");
-    Value nextValueMethod = getObjMethod(vm, receiver, "nextValue");
-    Value key = callReentrantMethod(vm, receiver, nextMethod, NIL_VAL);
-
-    ObjDictionary* selected = newDictionary(vm);
-    push(vm, OBJ_VAL(selected));
-    while (key != NIL_VAL) {
-        Value value = callReentrantMethod(vm, receiver, nextValueMethod, key);
-        Value result = callReentrantMethod(vm, receiver, closure, key, value);
-        if (!isFalsey(result)) dictSet(vm, selected, key, value);
-        key = callReentrantMethod(vm, receiver, nextMethod, key);
-    }
-    pop(vm);
-    RETURN_OBJ(selected);
+    push(vm, getObjMethod(vm, receiver, "next"));
+    push(vm, getObjMethod(vm, receiver, "nextValue"));
+    push(vm, NIL_VAL);
+    push(vm, NIL_VAL);
+    push(vm, OBJ_VAL(newDictionary(vm)));
+    RETURN_CONTINUATION(Dictionary, select);
 }
 
 LOX_METHOD(Dictionary, toString) {
@@ -1144,7 +1248,11 @@ LOX_METHOD(Dictionary, __getSubscript__) {
 
 LOX_METHOD(Dictionary, __setSubscript__) {
     ASSERT_ARG_COUNT("Dictionary::[]=(key, value)", 2);
-    if (!IS_NIL(args[0])) dictSet(vm, AS_DICTIONARY(receiver), args[0], args[1]);
+    if (!IS_NIL(args[0])) {
+        PROCESS_WRITE_BARRIER(AS_OBJ(receiver), args[0]);
+        PROCESS_WRITE_BARRIER(AS_OBJ(receiver), args[1]);
+        dictSet(vm, AS_DICTIONARY(receiver), args[0], args[1]);
+    }
     RETURN_OBJ(receiver);
 }
 
@@ -1361,6 +1469,7 @@ LOX_METHOD(LinkedList, putAt) {
 
     ObjNode* node = linkNode(vm, self, index);
     Value old = node->element;
+    PROCESS_WRITE_BARRIER((Obj*)node, args[1]);
     node->element = args[1];
     RETURN_VAL(old);
 }
@@ -1541,6 +1650,7 @@ LOX_METHOD(Queue, enqueue) {
         setObjProperty(vm, self, "last", OBJ_VAL(new));
     }
     else {
+        PROCESS_WRITE_BARRIER((Obj*)last, OBJ_VAL(new));
         last->next = new;
         setObjProperty(vm, self, "last", OBJ_VAL(new));
     }
@@ -2084,17 +2194,17 @@ void registerCollectionPackage(VM* vm) {
     DEF_INTERCEPTOR(collectionClass, Collection, INTERCEPTOR_INIT, __init__, 0, RETURN_TYPE(clox.std.collection.Collection));
     DEF_METHOD(collectionClass, Collection, add, 1, RETURN_TYPE(Bool), PARAM_TYPE(Object));
     DEF_METHOD(collectionClass, Collection, addAll, 1, RETURN_TYPE(void), PARAM_TYPE(clox.std.collection.Collection));
-    DEF_METHOD(collectionClass, Collection, collect, 1, RETURN_TYPE(clox.std.collection.Collection), PARAM_TYPE(TCallable));
-    DEF_METHOD(collectionClass, Collection, detect, 1, RETURN_TYPE(Object), PARAM_TYPE(TCallable));
-    DEF_METHOD(collectionClass, Collection, each, 1, RETURN_TYPE(void), PARAM_TYPE(TCallable));
+    DEF_METHOD_BORROWING(collectionClass, Collection, collect, 1, RETURN_TYPE(clox.std.collection.Collection), PARAM_TYPE(TCallable));
+    DEF_METHOD_BORROWING(collectionClass, Collection, detect, 1, RETURN_TYPE(Object), PARAM_TYPE(TCallable));
+    DEF_METHOD_BORROWING(collectionClass, Collection, each, 1, RETURN_TYPE(void), PARAM_TYPE(TCallable));
     DEF_METHOD(collectionClass, Collection, isEmpty, 0, RETURN_TYPE(Bool));
     DEF_METHOD(collectionClass, Collection, length, 0, RETURN_TYPE(Int));
-    DEF_METHOD(collectionClass, Collection, reject, 1, RETURN_TYPE(clox.std.collection.Collection), PARAM_TYPE(TCallable));
-    DEF_METHOD(collectionClass, Collection, select, 1, RETURN_TYPE(clox.std.collection.Collection), PARAM_TYPE(TCallable));
+    DEF_METHOD_BORROWING(collectionClass, Collection, reject, 1, RETURN_TYPE(clox.std.collection.Collection), PARAM_TYPE(TCallable));
+    DEF_METHOD_BORROWING(collectionClass, Collection, select, 1, RETURN_TYPE(clox.std.collection.Collection), PARAM_TYPE(TCallable));
     DEF_METHOD(collectionClass, Collection, toArray, 0, RETURN_TYPE(clox.std.collection.Array));
 
     bindSuperclass(vm, listClass, collectionClass);
-    DEF_METHOD(listClass, List, eachIndex, 1, RETURN_TYPE(Nil), PARAM_TYPE(TCallable));
+    DEF_METHOD_BORROWING(listClass, List, eachIndex, 1, RETURN_TYPE(Nil), PARAM_TYPE(TCallable));
     DEF_METHOD(listClass, List, getAt, 1, RETURN_TYPE(Object), PARAM_TYPE(Int));
     DEF_METHOD(listClass, List, putAt, 2, RETURN_TYPE(void), PARAM_TYPE(Int), PARAM_TYPE(Object));
 
@@ -2105,11 +2215,11 @@ void registerCollectionPackage(VM* vm) {
     DEF_METHOD(vm->arrayClass, Array, addAll, 1, RETURN_TYPE(Bool), PARAM_TYPE(clox.std.collection.Collection));
     DEF_METHOD(vm->arrayClass, Array, clear, 0, RETURN_TYPE(void));
     DEF_METHOD(vm->arrayClass, Array, clone, 0, RETURN_TYPE(clox.std.collection.Array));
-    DEF_METHOD(vm->arrayClass, Array, collect, 1, RETURN_TYPE(clox.std.collection.Array), PARAM_TYPE(TCallable));
+    DEF_METHOD_BORROWING(vm->arrayClass, Array, collect, 1, RETURN_TYPE(clox.std.collection.Array), PARAM_TYPE(TCallable));
     DEF_METHOD(vm->arrayClass, Array, contains, 1, RETURN_TYPE(Bool), PARAM_TYPE(Object));
-    DEF_METHOD(vm->arrayClass, Array, detect, 1, RETURN_TYPE(Object), PARAM_TYPE(TCallable));
-    DEF_METHOD(vm->arrayClass, Array, each, 1, RETURN_TYPE(void), PARAM_TYPE(TCallable));
-    DEF_METHOD(vm->arrayClass, Array, eachIndex, 1, RETURN_TYPE(void), PARAM_TYPE(TCallable));
+    DEF_METHOD_BORROWING(vm->arrayClass, Array, detect, 1, RETURN_TYPE(Object), PARAM_TYPE(TCallable));
+    DEF_METHOD_BORROWING(vm->arrayClass, Array, each, 1, RETURN_TYPE(void), PARAM_TYPE(TCallable));
+    DEF_METHOD_BORROWING(vm->arrayClass, Array, eachIndex, 1, RETURN_TYPE(void), PARAM_TYPE(TCallable));
     DEF_METHOD(vm->arrayClass, Array, equals, 1, RETURN_TYPE(Bool), PARAM_TYPE(Object));
     DEF_METHOD(vm->arrayClass, Array, fill, 2, RETURN_TYPE(void), PARAM_TYPE(Int), PARAM_TYPE(Object));
     DEF_METHOD(vm->arrayClass, Array, getAt, 1, RETURN_TYPE(Object), PARAM_TYPE(Int));
@@ -2121,10 +2231,10 @@ void registerCollectionPackage(VM* vm) {
     DEF_METHOD(vm->arrayClass, Array, next, 1, RETURN_TYPE(Int), PARAM_TYPE(Int));
     DEF_METHOD(vm->arrayClass, Array, nextValue, 1, RETURN_TYPE(Object), PARAM_TYPE(Int));
     DEF_METHOD(vm->arrayClass, Array, putAt, 2, RETURN_TYPE(void), PARAM_TYPE(Int), PARAM_TYPE(Object));
-    DEF_METHOD(vm->arrayClass, Array, reject, 1, RETURN_TYPE(clox.std.collection.Array), PARAM_TYPE(TCallable));
+    DEF_METHOD_BORROWING(vm->arrayClass, Array, reject, 1, RETURN_TYPE(clox.std.collection.Array), PARAM_TYPE(TCallable));
     DEF_METHOD(vm->arrayClass, Array, remove, 1, RETURN_TYPE(Bool), PARAM_TYPE(Object));
     DEF_METHOD(vm->arrayClass, Array, removeAt, 1, RETURN_TYPE(Bool), PARAM_TYPE(Int));
-    DEF_METHOD(vm->arrayClass, Array, select, 1, RETURN_TYPE(clox.std.collection.Array), PARAM_TYPE(TCallable));
+    DEF_METHOD_BORROWING(vm->arrayClass, Array, select, 1, RETURN_TYPE(clox.std.collection.Array), PARAM_TYPE(TCallable));
     DEF_METHOD(vm->arrayClass, Array, slice, 2, RETURN_TYPE(clox.std.collection.Array), PARAM_TYPE(Int), PARAM_TYPE(Int));
     DEF_METHOD(vm->arrayClass, Array, toString, 0, RETURN_TYPE(String));
     DEF_OPERATOR(vm->arrayClass, Array, [], __getSubscript__, 1, RETURN_TYPE(Object), PARAM_TYPE(Int));
@@ -2173,13 +2283,13 @@ void registerCollectionPackage(VM* vm) {
     DEF_INTERCEPTOR(vm->dictionaryClass, Dictionary, INTERCEPTOR_INIT, __init__, 0, RETURN_TYPE(clox.std.collection.Dictionary));
     DEF_METHOD(vm->dictionaryClass, Dictionary, clear, 0, RETURN_TYPE(void));
     DEF_METHOD(vm->dictionaryClass, Dictionary, clone, 0, RETURN_TYPE(clox.std.collection.Dictionary));
-    DEF_METHOD(vm->dictionaryClass, Dictionary, collect, 1, RETURN_TYPE(clox.std.collection.Dictionary), PARAM_TYPE(TCallable));
+    DEF_METHOD_BORROWING(vm->dictionaryClass, Dictionary, collect, 1, RETURN_TYPE(clox.std.collection.Dictionary), PARAM_TYPE(TCallable));
     DEF_METHOD(vm->dictionaryClass, Dictionary, containsKey, 1, RETURN_TYPE(Bool), PARAM_TYPE(Object));
     DEF_METHOD(vm->dictionaryClass, Dictionary, containsValue, 1, RETURN_TYPE(Bool), PARAM_TYPE(Object));
-    DEF_METHOD(vm->dictionaryClass, Dictionary, detect, 1, RETURN_TYPE(Object), PARAM_TYPE(TCallable));
-    DEF_METHOD(vm->dictionaryClass, Dictionary, each, 1, RETURN_TYPE(void), PARAM_TYPE(TCallable));
-    DEF_METHOD(vm->dictionaryClass, Dictionary, eachKey, 1, RETURN_TYPE(void), PARAM_TYPE(TCallable));
-    DEF_METHOD(vm->dictionaryClass, Dictionary, eachValue, 1, RETURN_TYPE(void), PARAM_TYPE(TCallable));
+    DEF_METHOD_BORROWING(vm->dictionaryClass, Dictionary, detect, 1, RETURN_TYPE(Object), PARAM_TYPE(TCallable));
+    DEF_METHOD_BORROWING(vm->dictionaryClass, Dictionary, each, 1, RETURN_TYPE(void), PARAM_TYPE(TCallable));
+    DEF_METHOD_BORROWING(vm->dictionaryClass, Dictionary, eachKey, 1, RETURN_TYPE(void), PARAM_TYPE(TCallable));
+    DEF_METHOD_BORROWING(vm->dictionaryClass, Dictionary, eachValue, 1, RETURN_TYPE(void), PARAM_TYPE(TCallable));
     DEF_METHOD(vm->dictionaryClass, Dictionary, entrySet, 0, RETURN_TYPE(clox.std.collection.Set));
     DEF_METHOD(vm->dictionaryClass, Dictionary, equals, 1, RETURN_TYPE(Bool), PARAM_TYPE(Object));
     DEF_METHOD(vm->dictionaryClass, Dictionary, getAt, 1, RETURN_TYPE(Object), PARAM_TYPE(Int));
@@ -2190,9 +2300,9 @@ void registerCollectionPackage(VM* vm) {
     DEF_METHOD(vm->dictionaryClass, Dictionary, nextValue, 1, RETURN_TYPE(Object), PARAM_TYPE(Int));
     DEF_METHOD(vm->dictionaryClass, Dictionary, putAll, 1, RETURN_TYPE(void), PARAM_TYPE(clox.std.collection.Dictionary));
     DEF_METHOD(vm->dictionaryClass, Dictionary, putAt, 2, RETURN_TYPE(void), PARAM_TYPE(Object), PARAM_TYPE(Object));
-    DEF_METHOD(vm->dictionaryClass, Dictionary, reject, 1, RETURN_TYPE(clox.std.collection.Dictionary), PARAM_TYPE(TCallable));
+    DEF_METHOD_BORROWING(vm->dictionaryClass, Dictionary, reject, 1, RETURN_TYPE(clox.std.collection.Dictionary), PARAM_TYPE(TCallable));
     DEF_METHOD(vm->dictionaryClass, Dictionary, removeAt, 1, RETURN_TYPE(Object), PARAM_TYPE(Int));
-    DEF_METHOD(vm->dictionaryClass, Dictionary, select, 1, RETURN_TYPE(clox.std.collection.Dictionary), PARAM_TYPE(TCallable));
+    DEF_METHOD_BORROWING(vm->dictionaryClass, Dictionary, select, 1, RETURN_TYPE(clox.std.collection.Dictionary), PARAM_TYPE(TCallable));
     DEF_METHOD(vm->dictionaryClass, Dictionary, toString, 0, RETURN_TYPE(String));
     DEF_METHOD(vm->dictionaryClass, Dictionary, valueSet, 0, RETURN_TYPE(clox.std.collection.Set));
     DEF_OPERATOR(vm->dictionaryClass, Dictionary, [], __getSubscript__, 1, RETURN_TYPE(Object), PARAM_TYPE(Object));
@@ -2236,7 +2346,7 @@ void registerCollectionPackage(VM* vm) {
     DEF_METHOD(vm->rangeClass, Range, min, 0, RETURN_TYPE(Int));
     DEF_METHOD(vm->rangeClass, Range, next, 1, RETURN_TYPE(Int), PARAM_TYPE(Int));
     DEF_METHOD(vm->rangeClass, Range, nextValue, 1, RETURN_TYPE(Object), PARAM_TYPE(Int));
-    DEF_METHOD(vm->rangeClass, Range, step, 2, RETURN_TYPE(void), PARAM_TYPE(Int), PARAM_TYPE(TCallable));
+    DEF_METHOD_BORROWING(vm->rangeClass, Range, step, 2, RETURN_TYPE(void), PARAM_TYPE(Int), PARAM_TYPE(TCallable));
     DEF_METHOD(vm->rangeClass, Range, to, 0, RETURN_TYPE(Int));
     DEF_METHOD(vm->rangeClass, Range, toArray, 0, RETURN_TYPE(clox.std.collection.Array));
     DEF_METHOD(vm->rangeClass, Range, toString, 0, RETURN_TYPE(String));
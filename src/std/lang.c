@@ -345,11 +345,10 @@ LOX_METHOD(Class, toString) {
 LOX_METHOD(Class, __invoke__) { 
     ObjClass* self = AS_CLASS(receiver);
     ObjInstance* instance = newInstance(vm, self);
-    Value initMethod;
     push(vm, OBJ_VAL(instance));
 
-    if (tableGet(&self->methods, vm->initString, &initMethod)) {
-        callReentrantMethod(vm, receiver, initMethod, args);
+    if (!IS_NIL(self->initializer)) {
+        callReentrantMethod(vm, receiver, self->initializer, args);
     }
     pop(vm);
     RETURN_OBJ(instance);
@@ -623,6 +622,7 @@ LOX_METHOD(Generator, send) {
 LOX_METHOD(Generator, setReceiver) {
     ASSERT_ARG_COUNT("Generator::setReceiver(receiver)", 1);
     ObjGenerator* self = AS_GENERATOR(receiver);
+    PROCESS_WRITE_BARRIER((Obj*)self->frame, args[0]);
     self->frame->slots[0] = args[0];
     RETURN_NIL;
 }
@@ -883,7 +883,7 @@ LOX_METHOD(Metaclass, memberOf) {
 LOX_METHOD(Metaclass, namedInstance) {
     ASSERT_ARG_COUNT("Metaclass::namedInstance()", 0);
     ObjClass* self = AS_CLASS(receiver);
-    ObjString* className = subString(vm, self->fullName, 0, self->name->length - 7);
+    ObjString* className = internString(vm, subString(vm, self->fullName, 0, self->name->length - 7));
     RETURN_OBJ(getNativeClass(vm, className->chars));
 }
 
@@ -915,6 +915,7 @@ LOX_METHOD(Method, __init__) {
         THROW_EXCEPTION_FMT(clox.std.lang.UnsupportedOperationException, "Method %s already exists in behavior %s.", name->chars, behavior->fullName->chars);
     }
     tableSet(vm, &behavior->methods, name, OBJ_VAL(closure));
+    if (name == vm->initString) behavior->initializer = OBJ_VAL(closure);
 
     self->behavior = behavior;
     self->closure = closure;
@@ -1338,7 +1339,7 @@ LOX_METHOD(Object, getField) {
     ASSERT_ARG_TYPE("Object::getField(field)", 0, String);
     if (IS_INSTANCE(receiver)) {
         ObjInstance* instance = AS_INSTANCE(receiver);
-        IDMap* idMap = getShapeIndexes(vm, instance->obj.shapeID);
+        IDMap* idMap = getObjectIndexes(vm, &instance->obj);
         int index;
         if (idMapGet(idMap, AS_STRING(args[0]), &index)) RETURN_VAL(instance->fields.values[index]);
     }
@@ -1350,7 +1351,7 @@ LOX_METHOD(Object, hasField) {
     ASSERT_ARG_TYPE("Object::hasField(field)", 0, String);
     if (IS_INSTANCE(receiver)) {
         ObjInstance* instance = AS_INSTANCE(receiver);
-        IDMap* indexMap = getShapeIndexes(vm, instance->obj.shapeID);
+        IDMap* indexMap = getObjectIndexes(vm, &instance->obj);
         int index;
         RETURN_BOOL(idMapGet(indexMap, AS_STRING(args[0]), &index));
     }
@@ -1388,7 +1389,7 @@ LOX_METHOD(Object, toString) {
 
 LOX_METHOD(Object, __equal__) {
     ASSERT_ARG_COUNT("Object::==(other)", 1);
-    RETURN_BOOL(receiver == args[0]);
+    RETURN_BOOL(valuesEqual(receiver, args[0]));
 }
 
 LOX_METHOD(String, __init__) {
@@ -1419,7 +1420,8 @@ LOX_METHOD(String, contains) {
 LOX_METHOD(String, count) {
     ASSERT_ARG_COUNT("String::count()", 0);
     ObjString* self = AS_STRING(receiver);
-    RETURN_INT((int)utf8len(self->chars));
+    if (isAsciiObjString(self)) RETURN_INT(self->length);
+    RETURN_INT(utf8CodePointCount(self->chars, self->length));
 }
 
 LOX_METHOD(String, decapitalize) {
@@ -1453,6 +1455,7 @@ LOX_METHOD(String, getCodePoint) {
     ObjString* self = AS_STRING(receiver);
     int index = AS_INT(args[0]);
     ASSERT_INDEX_WITHIN_BOUNDS("String::getCodePoint(index)", index, 0, self->length, 0);
+    if (isAsciiObjString(self)) RETURN_OBJ(charString(vm, self->chars[index]));
     RETURN_OBJ(utf8CodePointAtIndex(vm, self->chars, index));
 }
 
@@ -1480,6 +1483,7 @@ LOX_METHOD(String, next) {
     ASSERT_ARG_TYPE("String::next(index)", 0, Int);
     int index = AS_INT(args[0]);
     if (index < 0 || index < self->length - 1) {
+        if (isAsciiObjString(self)) RETURN_INT(index + 1);
         RETURN_INT(index + utf8CodePointOffset(vm, self->chars, index));
     }
     RETURN_NIL;
@@ -1491,6 +1495,7 @@ LOX_METHOD(String, nextValue) {
     ObjString* self = AS_STRING(receiver);
     int index = AS_INT(args[0]);
     if (index > -1 && index < self->length) {
+        if (isAsciiObjString(self)) RETURN_OBJ(charString(vm, self->chars[index]));
         RETURN_OBJ(utf8CodePointAtIndex(vm, self->chars, index));
     }
     RETURN_NIL;
@@ -1518,14 +1523,26 @@ LOX_METHOD(String, split) {
 
     ObjArray* array = newArray(vm);
     push(vm, OBJ_VAL(array));
-    char* string = _strdup(self->chars);
-    char* next = NULL;
-    char* token = strtok_s(string, delimiter->chars, &next);
-    while (token != NULL) {
-        valueArrayWrite(vm, &array->elements, OBJ_VAL(newString(vm, token)));
-        token = strtok_s(NULL, delimiter->chars, &next);
+    const char* cursor = self->chars;
+    const char* end = self->chars + self->length;
+    while (cursor < end) {
+        const char* token = cursor;
+        const char* tokenEnd;
+        if (delimiter->length == 1) {
+            while (token < end && *token == delimiter->chars[0]) token++;
+            if (token == end) break;
+            tokenEnd = memchr(token, delimiter->chars[0], end - token);
+            if (tokenEnd == NULL) tokenEnd = end;
+        }
+        else {
+            token += strspn(token, delimiter->chars);
+            if (token >= end) break;
+            tokenEnd = token + strcspn(token, delimiter->chars);
+        }
+
+        valueArrayWrite(vm, &array->elements, OBJ_VAL(copyStringTransient(vm, token, (int)(tokenEnd - token))));
+        cursor = tokenEnd;
     }
-    free(string);
     pop(vm);
     RETURN_OBJ(array);
 }
@@ -1565,6 +1582,14 @@ LOX_METHOD(String, toCodePoints) {
     ObjArray* codePoints = newArray(vm);
     push(vm, OBJ_VAL(codePoints));
 
+    if (isAsciiObjString(self)) {
+        for (int i = 0; i < self->length; i++) {
+            valueArrayWrite(vm, &codePoints->elements, OBJ_VAL(charString(vm, self->chars[i])));
+        }
+        pop(vm);
+        RETURN_OBJ(codePoints);
+    }
+
     int i = 0;
     while (i < self->length) {
         ObjString* codePoint = utf8CodePointAtIndex(vm, self->chars, i);
@@ -1607,8 +1632,7 @@ LOX_METHOD(String, __getSubscript__) {
     ObjString* self = AS_STRING(receiver);
     int index = AS_INT(args[0]);
     ASSERT_INDEX_WITHIN_BOUNDS("String::[](index)", index, 0, self->length, 0);
-    char chars[2] = { self->chars[index], '\0' };
-    RETURN_STRING(chars, 1);
+    RETURN_OBJ(charString(vm, self->chars[index]));
 }
 
 LOX_METHOD(StringClass, fromByte) {
@@ -1625,6 +1649,72 @@ LOX_METHOD(StringClass, fromCodePoint) {
     RETURN_OBJ(utf8StringFromCodePoint(vm, AS_INT(args[0])));
 }
 
+LOX_METHOD(StringBuilder, __init__) {
+    ASSERT_ARG_COUNT("StringBuilder::__init__()", 0);
+    ObjInstance* self = AS_INSTANCE(receiver);
+    ObjArray* parts = newArray(vm);
+    push(vm, OBJ_VAL(parts));
+    setObjProperty(vm, self, "parts", OBJ_VAL(parts));
+    setObjProperty(vm, self, "count", INT_VAL(0));
+    pop(vm);
+    RETURN_OBJ(receiver);
+}
+
+LOX_METHOD(StringBuilder, append) {
+    ASSERT_ARG_COUNT("StringBuilder::append(string)", 1);
+    ASSERT_ARG_TYPE("StringBuilder::append(string)", 0, String);
+    ObjInstance* self = AS_INSTANCE(receiver);
+    ObjArray* parts = AS_ARRAY(getObjProperty(vm, self, "parts"));
+    int length = AS_INT(getObjProperty(vm, self, "count"));
+
+    PROCESS_WRITE_BARRIER((Obj*)parts, args[0]);
+    valueArrayWrite(vm, &parts->elements, args[0]);
+    setObjProperty(vm, self, "count", INT_VAL(length + AS_STRING(args[0])->length));
+    RETURN_OBJ(receiver);
+}
+
+LOX_METHOD(StringBuilder, clear) {
+    ASSERT_ARG_COUNT("StringBuilder::clear()", 0);
+    ObjInstance* self = AS_INSTANCE(receiver);
+    ObjArray* parts = AS_ARRAY(getObjProperty(vm, self, "parts"));
+    parts->elements.count = 0;
+    setObjProperty(vm, self, "count", INT_VAL(0));
+    RETURN_OBJ(receiver);
+}
+
+LOX_METHOD(StringBuilder, isEmpty) {
+    ASSERT_ARG_COUNT("StringBuilder::isEmpty()", 0);
+    RETURN_BOOL(AS_INT(getObjProperty(vm, AS_INSTANCE(receiver), "count")) == 0);
+}
+
+LOX_METHOD(StringBuilder, length) {
+    ASSERT_ARG_COUNT("StringBuilder::length()", 0);
+    RETURN_VAL(getObjProperty(vm, AS_INSTANCE(receiver), "count"));
+}
+
+LOX_METHOD(StringBuilder, toString) {
+    ASSERT_ARG_COUNT("StringBuilder::toString()", 0);
+    ObjInstance* self = AS_INSTANCE(receiver);
+    ObjArray* parts = AS_ARRAY(getObjProperty(vm, self, "parts"));
+    if (parts->elements.count == 1) RETURN_VAL(parts->elements.values[0]);
+
+    int length = AS_INT(getObjProperty(vm, self, "count"));
+    char* chars = ALLOCATE(char, length + 1, GC_GENERATION_TYPE_EDEN);
+    int offset = 0;
+    for (int i = 0; i < parts->elements.count; i++) {
+        ObjString* part = AS_STRING(parts->elements.values[i]);
+        memcpy(chars + offset, part->chars, part->length);
+        offset += part->length;
+    }
+    chars[length] = '\0';
+
+    ObjString* result = takeStringTransient(vm, chars, length);
+    PROCESS_WRITE_BARRIER((Obj*)parts, OBJ_VAL(result));
+    parts->elements.values[0] = OBJ_VAL(result);
+    parts->elements.count = 1;
+    RETURN_OBJ(result);
+}
+
 LOX_METHOD(TCallable, arity) {
     THROW_EXCEPTION(clox.std.lang.NotImplementedException, "Not implemented, subclass responsibility.");
 }
@@ -1993,7 +2083,7 @@ void registerLangPackage(VM* vm) {
     DEF_METHOD(vm->numberClass, Number, round, 0, RETURN_TYPE(Number));
     DEF_METHOD(vm->numberClass, Number, sin, 0, RETURN_TYPE(Number));
     DEF_METHOD(vm->numberClass, Number, sqrt, 0, RETURN_TYPE(Number));
-    DEF_METHOD(vm->numberClass, Number, step, 3, RETURN_TYPE(void), PARAM_TYPE(Number), PARAM_TYPE(Number), PARAM_TYPE(Object));
+    DEF_METHOD_BORROWING(vm->numberClass, Number, step, 3, RETURN_TYPE(void), PARAM_TYPE(Number), PARAM_TYPE(Number), PARAM_TYPE(Object));
     DEF_METHOD(vm->numberClass, Number, tan, 0, RETURN_TYPE(Number));
     DEF_METHOD(vm->numberClass, Number, toInt, 0, RETURN_TYPE(Number));
     DEF_METHOD(vm->numberClass, Number, toString, 0, RETURN_TYPE(String));
@@ -2016,20 +2106,20 @@ void registerLangPackage(VM* vm) {
     DEF_INTERCEPTOR(vm->intClass, Int, INTERCEPTOR_INIT, __init__, 1, RETURN_TYPE(Int), PARAM_TYPE(Object));
     DEF_METHOD(vm->intClass, Int, abs, 0, RETURN_TYPE(Int));
     DEF_METHOD(vm->intClass, Int, clone, 0, RETURN_TYPE(Int));
-    DEF_METHOD(vm->intClass, Int, downTo, 2, RETURN_TYPE(void), PARAM_TYPE(Int), PARAM_TYPE(Object));
+    DEF_METHOD_BORROWING(vm->intClass, Int, downTo, 2, RETURN_TYPE(void), PARAM_TYPE(Int), PARAM_TYPE(Object));
     DEF_METHOD(vm->intClass, Int, factorial, 0, RETURN_TYPE(Int));
     DEF_METHOD(vm->intClass, Int, gcd, 1, RETURN_TYPE(Int), PARAM_TYPE(Int));
     DEF_METHOD(vm->intClass, Int, isEven, 0, RETURN_TYPE(Bool));
     DEF_METHOD(vm->intClass, Int, isOdd, 0, RETURN_TYPE(Bool));
     DEF_METHOD(vm->intClass, Int, lcm, 1, RETURN_TYPE(Int), PARAM_TYPE(Int));
     DEF_METHOD(vm->intClass, Int, objectID, 0, RETURN_TYPE(Int));
-    DEF_METHOD(vm->intClass, Int, timesRepeat, 1, RETURN_TYPE(void));
+    DEF_METHOD_BORROWING(vm->intClass, Int, timesRepeat, 1, RETURN_TYPE(void));
     DEF_METHOD(vm->intClass, Int, toBinary, 0, RETURN_TYPE(Int));
     DEF_METHOD(vm->intClass, Int, toFloat, 0, RETURN_TYPE(Int));
     DEF_METHOD(vm->intClass, Int, toHexadecimal, 0, RETURN_TYPE(Int));
     DEF_METHOD(vm->intClass, Int, toOctal, 0, RETURN_TYPE(Int));
     DEF_METHOD(vm->intClass, Int, toString, 0, RETURN_TYPE(String));
-    DEF_METHOD(vm->intClass, Int, upTo, 2, RETURN_TYPE(void), PARAM_TYPE(Int), PARAM_TYPE(Object));
+    DEF_METHOD_BORROWING(vm->intClass, Int, upTo, 2, RETURN_TYPE(void), PARAM_TYPE(Int), PARAM_TYPE(Object));
     DEF_OPERATOR(vm->intClass, Int, +, __add__, 1, RETURN_TYPE(Int), PARAM_TYPE(Int));
     DEF_OPERATOR(vm->intClass, Int, -, __subtract__, 1, RETURN_TYPE(Int), PARAM_TYPE(Int));
     DEF_OPERATOR(vm->intClass, Int, *, __multiply__, 1, RETURN_TYPE(Int), PARAM_TYPE(Int));
@@ -2088,6 +2178,16 @@ void registerLangPackage(VM* vm) {
     DEF_METHOD(stringMetaclass, StringClass, fromByte, 1, RETURN_TYPE(String), PARAM_TYPE(Object));
     DEF_METHOD(stringMetaclass, StringClass, fromCodePoint, 1, RETURN_TYPE(String), PARAM_TYPE(Object));
 
+    ObjClass* stringBuilderClass = defineNativeClass(vm, "StringBuilder");
+    bindSuperclass(vm, stringBuilderClass, vm->objectClass);
+    DEF_INTERCEPTOR(stringBuilderClass, StringBuilder, INTERCEPTOR_INIT, __init__, 0, RETURN_TYPE(StringBuilder));
+    DEF_METHOD(stringBuilderClass, StringBuilder, append, 1, RETURN_TYPE(StringBuilder), PARAM_TYPE(String));
+    DEF_METHOD(stringBuilderClass, StringBuilder, clear, 0, RETURN_TYPE(StringBuilder));
+    DEF_METHOD(stringBuilderClass, StringBuilder, isEmpty, 0, RETURN_TYPE(Bool));
+    DEF_METHOD(stringBuilderClass, StringBuilder, length, 0, RETURN_TYPE(Int));
+    DEF_METHOD(stringBuilderClass, StringBuilder, toString, 0, RETURN_TYPE(String));
+    insertGlobalSymbolTable(vm, "StringBuilder", classType);
+
     DEF_METHOD(callableTrait, TCallable, arity, 0, RETURN_TYPE(Int));
     DEF_METHOD(callableTrait, TCallable, isAsync, 0, RETURN_TYPE(Bool));
     DEF_METHOD(callableTrait, TCallable, isNative, 0, RETURN_TYPE(Bool));
@@ -23,8 +23,15 @@ void initClass(VM* vm, ObjClass* klass, ObjString* name, ObjClass* metaclass, Be
     klass->name = name != NULL ? name : emptyString(vm);
     klass->namespace = vm->currentNamespace;
     klass->superclass = NULL;
+    klass->depth = 0;
+    memset(klass->display, 0, sizeof(klass->display));
+    klass->display[0] = klass;
+    klass->traitSet = NULL;
+    klass->traitSetCount = 0;
     klass->isNative = false;
     klass->interceptors = 0;
+    klass->instanceFieldCount = 0;
+    klass->shapeCount = 0;
 
     if (!klass->namespace->isRoot) {
         char chars[UINT8_MAX];
@@ -37,6 +44,7 @@ void initClass(VM* vm, ObjClass* klass, ObjString* name, ObjClass* metaclass, Be
     initIDMap(&klass->indexes, klass->obj.generation);
     initValueArray(&klass->fields, klass->obj.generation);
     initTable(&klass->methods, klass->obj.generation);
+    klass->initializer = NIL_VAL;
     pop(vm);
 }
 
@@ -54,8 +62,15 @@ void initTrait(VM* vm, ObjClass* trait, ObjString* name) {
     trait->name = (name != NULL) ? name : createBehaviorName(vm, BEHAVIOR_TRAIT, NULL);
     trait->namespace = vm->currentNamespace;
     trait->superclass = NULL;
+    trait->depth = 0;
+    memset(trait->display, 0, sizeof(trait->display));
+    trait->display[0] = trait;
+    trait->traitSet = NULL;
+    trait->traitSetCount = 0;
     trait->isNative = false;
     trait->interceptors = 0;
+    trait->instanceFieldCount = 0;
+    trait->shapeCount = 0;
 
     if (!trait->namespace->isRoot) {
         char chars[UINT8_MAX];
@@ -68,6 +83,7 @@ void initTrait(VM* vm, ObjClass* trait, ObjString* name) {
     initIDMap(&trait->indexes, trait->obj.generation);
     initValueArray(&trait->fields, trait->obj.generation);
     initTable(&trait->methods, trait->obj.generation);
+    trait->initializer = NIL_VAL;
     pop(vm);
 }
 
@@ -87,7 +103,7 @@ ObjClass* getObjClass(VM* vm, Value value) {
 }
 
 ObjString* getClassNameFromMetaclass(VM* vm, ObjString* metaclassName) {
-    return subString(vm, metaclassName, 0, metaclassName->length - 7);
+    return internString(vm, subString(vm, metaclassName, 0, metaclassName->length - 7));
 }
 
 ObjString* getMetaclassNameFromClass(VM* vm, ObjString* className) {
@@ -100,33 +116,59 @@ ObjString* getClassFullName(VM* vm, ObjString* shortName, ObjString* currentName
     return concatenateString(vm, currentNamespace, shortName, ".");
 }
 
+void cacheClassInitializer(VM* vm, ObjClass* klass) {
+    Value initializer;
+    klass->initializer = tableGet(&klass->methods, vm->initString, &initializer) ? initializer : NIL_VAL;
+}
+
 bool isObjInstanceOf(VM* vm, Value value, ObjClass* klass) {
     ObjClass* currentClass = getObjClass(vm, value);
-    if (currentClass == klass) return true;
-    if (isClassExtendingSuperclass(currentClass->superclass, klass)) return true;
+    if (isClassExtendingSuperclass(currentClass, klass)) return true;
     return isClassImplementingTrait(currentClass, klass);
 }
 
 bool isClassExtendingSuperclass(ObjClass* klass, ObjClass* superclass) {
     if (klass == superclass) return true;
-    if (klass->behaviorType == BEHAVIOR_TRAIT) return false;
+    if (klass->behaviorType == BEHAVIOR_TRAIT || superclass->depth >= klass->depth) return false;
+    if (superclass->depth < CLASS_DISPLAY_SIZE) return klass->display[superclass->depth] == superclass;
 
-    ObjClass* currentClass = klass->superclass;
-    while (currentClass != NULL) {
-        if (currentClass == superclass) return true;
+    ObjClass* currentClass = klass;
+    while (currentClass->depth > superclass->depth) {
         currentClass = currentClass->superclass;
     }
-    return false;
+    return currentClass == superclass;
 }
 
 bool isClassImplementingTrait(ObjClass* klass, ObjClass* trait) {
-    if (klass->behaviorType == BEHAVIOR_METACLASS || klass->traits.count == 0) return false;
-    ValueArray* traits = &klass->traits;
+    if (klass->behaviorType == BEHAVIOR_METACLASS) return false;
+    int word = trait->behaviorID / 64;
+    if (word >= klass->traitSetCount) return false;
+    return (klass->traitSet[word] & (1ULL << (trait->behaviorID % 64))) != 0;
+}
 
-    for (int i = 0; i < traits->count; i++) {
-        if (AS_CLASS(traits->values[i]) == trait) return true;
+static void updateTraitSet(VM* vm, ObjClass* klass) {
+    int count = 0;
+    for (int i = 0; i < klass->traits.count; i++) {
+        int word = AS_CLASS(klass->traits.values[i])->behaviorID / 64;
+        if (word >= count) count = word + 1;
+    }
+
+    if (count > klass->traitSetCount) {
+        klass->traitSet = GROW_ARRAY(uint64_t, klass->traitSet, klass->traitSetCount, count, klass->obj.generation);
+        klass->traitSetCount = count;
+    }
+    if (klass->traitSetCount > 0) memset(klass->traitSet, 0, sizeof(uint64_t) * klass->traitSetCount);
+
+    for (int i = 0; i < klass->traits.count; i++) {
+        int behaviorID = AS_CLASS(klass->traits.values[i])->behaviorID;
+        klass->traitSet[behaviorID / 64] |= 1ULL << (behaviorID % 64);
     }
-    return false;
+}
+
+static void inheritDisplay(ObjClass* subclass, ObjClass* superclass) {
+    subclass->depth = superclass->depth + 1;
+    memcpy(subclass->display, superclass->display, sizeof(subclass->display));
+    if (subclass->depth < CLASS_DISPLAY_SIZE) subclass->display[subclass->depth] = subclass;
 }
 
 static void inheritTraits(VM* vm, ObjClass* subclass, ObjClass* superclass) {
@@ -139,14 +181,17 @@ static void inheritTraits(VM* vm, ObjClass* subclass, ObjClass* superclass) {
             TypeInfoArrayAdd(subclassType->traitTypes, traitType);
         }
     }
+    updateTraitSet(vm, subclass);
 }
 
 static void inheritMethods(VM* vm, ObjClass* subclass, ObjClass* superclass) {
     tableAddAll(vm, &superclass->methods, &subclass->methods);
+    cacheClassInitializer(vm, subclass);
 }
 
 void inheritSuperclass(VM* vm, ObjClass* subclass, ObjClass* superclass) {
     subclass->superclass = superclass;
+    inheritDisplay(subclass, superclass);
     subclass->classType = superclass->classType;
     subclass->interceptors = superclass->interceptors;
 
@@ -209,6 +254,7 @@ static void flattenTraits(VM* vm, ObjClass* klass, ValueArray* traits) {
     freeValueArray(vm, traits);
     copyTraitsFromTable(vm, klass, &traitTable);
     freeTable(vm, &traitTable);
+    updateTraitSet(vm, klass);
 }
 
 void implementTraits(VM* vm, ObjClass* klass, ValueArray* traits) {
@@ -217,15 +263,18 @@ void implementTraits(VM* vm, ObjClass* klass, ValueArray* traits) {
         ObjClass* trait = AS_CLASS(traits->values[i]);
         tableAddAll(vm, &trait->methods, &klass->methods);
     }
+    cacheClassInitializer(vm, klass);
     flattenTraits(vm, klass, traits);
 }
 
 void bindTrait(VM* vm, ObjClass* klass, ObjClass* trait) {
     tableAddAll(vm, &trait->methods, &klass->methods);
+    cacheClassInitializer(vm, klass);
     valueArrayWrite(vm, &klass->traits, OBJ_VAL(trait));
     for (int i = 0; i < trait->traits.count; i++) {
         valueArrayWrite(vm, &klass->traits, trait->traits.values[i]);
     }
+    updateTraitSet(vm, klass);
 }
 
 void bindTraits(VM* vm, int numTraits, ObjClass* klass, ...) {
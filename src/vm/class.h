@@ -18,9 +18,10 @@ ObjClass* getObjClass(VM* vm, Value value);
 ObjString* getClassNameFromMetaclass(VM* vm, ObjString* metaclassName);
 ObjString* getMetaclassNameFromClass(VM* vm, ObjString* className);
 ObjString* getClassFullName(VM* vm, ObjString* shortName, ObjString* currentNamespace);
+void cacheClassInitializer(VM* vm, ObjClass* klass);
 bool isObjInstanceOf(VM* vm, Value value, ObjClass* klass);
 bool isClassExtendingSuperclass(ObjClass* klass, ObjClass* superclass);
-bool isClassImplementingTrait(ObjClass* trait, ObjClass* klass);
+bool isClassImplementingTrait(ObjClass* klass, ObjClass* trait);
 void inheritSuperclass(VM* vm, ObjClass* subclass, ObjClass* superclass);
 void bindSuperclass(VM* vm, ObjClass* subclass, ObjClass* superclass);
 void implementTraits(VM* vm, ObjClass* klass, ValueArray* traits);
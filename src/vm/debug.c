@@ -54,6 +54,17 @@ static int jumpInstruction(const char* name, int sign, Chunk* chunk, int offset)
     return offset + 3;
 }
 
+static int iterateInstruction(const char* name, Chunk* chunk, int offset) {
+    uint8_t collectionSlot = chunk->code[offset + 1];
+    uint8_t indexSlot = chunk->code[offset + 2];
+    uint16_t exitJump = (uint16_t)(chunk->code[offset + 3] << 8);
+    exitJump |= chunk->code[offset + 4];
+    uint16_t bodyJump = (uint16_t)(chunk->code[offset + 5] << 8);
+    bodyJump |= chunk->code[offset + 6];
+    printf("%-16s %4d %4d -> %d, %d\n", name, collectionSlot, indexSlot, offset + 7 + exitJump, offset + 7 + bodyJump);
+    return offset + 7;
+}
+
 static int exceptionHandlerInstruction(const char* name, Chunk* chunk, int offset) {
     uint8_t exceptionType = chunk->code[offset + 1];
     uint16_t handlerAddress = (uint16_t)(chunk->code[offset + 2] << 8);
@@ -115,6 +126,12 @@ int disassembleInstruction(Chunk* chunk, int offset) {
             return identifierInstruction("OP_GET_GLOBAL", chunk, offset);
         case OP_SET_GLOBAL:
             return identifierInstruction("OP_SET_GLOBAL", chunk, offset);
+        case OP_GET_GLOBAL_VAL:
+            return byteInstruction("OP_GET_GLOBAL_VAL", chunk, offset);
+        case OP_GET_GLOBAL_VAR:
+            return byteInstruction("OP_GET_GLOBAL_VAR", chunk, offset);
+        case OP_SET_GLOBAL_VAR:
+            return byteInstruction("OP_SET_GLOBAL_VAR", chunk, offset);
         case OP_GET_UPVALUE:
             return byteInstruction("OP_GET_UPVALUE", chunk, offset);
         case OP_SET_UPVALUE:
@@ -141,6 +158,8 @@ int disassembleInstruction(Chunk* chunk, int offset) {
             return simpleInstruction("OP_LESS", offset);
         case OP_ADD:
             return simpleInstruction("OP_ADD", offset);
+        case OP_BUILD_STRING:
+            return byteInstruction("OP_BUILD_STRING", chunk, offset);
         case OP_SUBTRACT:
             return simpleInstruction("OP_SUBTRACT", offset);
         case OP_MULTIPLY:
@@ -163,8 +182,14 @@ int disassembleInstruction(Chunk* chunk, int offset) {
             return jumpInstruction("OP_JUMP_IF_FALSE", 1, chunk, offset);
         case OP_JUMP_IF_EMPTY:
             return jumpInstruction("OP_JUMP_IF_EMPTY", 1, chunk, offset);
+        case OP_JUMP_IF_INT_BOUNDS:
+            return jumpInstruction("OP_JUMP_IF_INT_BOUNDS", 1, chunk, offset);
         case OP_LOOP:
             return jumpInstruction("OP_LOOP", -1, chunk, offset);
+        case OP_FOR_ITER:
+            return iterateInstruction("OP_FOR_ITER", chunk, offset);
+        case OP_FOR_ITER_RANGE:
+            return iterateInstruction("OP_FOR_ITER_RANGE", chunk, offset);
         case OP_CALL:
             return byteInstruction("OP_CALL", chunk, offset);
         case OP_OPTIONAL_CALL: 
@@ -177,6 +202,8 @@ int disassembleInstruction(Chunk* chunk, int offset) {
             return identifierInstruction("OP_OPTIONAL_INVOKE", chunk, offset);
         case OP_CLOSURE:
             return closureInstruction("OP_CLOSURE", chunk, offset);
+        case OP_BORROW_CLOSURE:
+            return closureInstruction("OP_BORROW_CLOSURE", chunk, offset);
         case OP_CLOSE_UPVALUE:
             return simpleInstruction("OP_CLOSE_UPVALUE", offset);
         case OP_CLASS:
@@ -3,10 +3,12 @@
 #include "dict.h"
 #include "hash.h"
 #include "memory.h"
+#include "string.h"
 
 ObjEntry* dictFindEntry(ObjEntry* entries, int capacity, Value key) {
     uint32_t hash = hashValue(key);
     uint32_t index = hash & (capacity - 1);
+    ObjString* transientKey = (IS_STRING(key) && !AS_STRING(key)->isInterned) ? AS_STRING(key) : NULL;
     ObjEntry* tombstone = NULL;
 
     for (;;) {
@@ -19,7 +21,7 @@ ObjEntry* dictFindEntry(ObjEntry* entries, int capacity, Value key) {
                 if (tombstone == NULL) tombstone = entry;
             }
         }
-        else if (entry->key == key) {
+        else if (entry->key == key || (transientKey != NULL && IS_STRING(entry->key) && stringsEqual(AS_STRING(entry->key), transientKey))) {
             return entry;
         }
 
@@ -27,6 +29,30 @@ ObjEntry* dictFindEntry(ObjEntry* entries, int capacity, Value key) {
     }
 }
 
+int dictFindIndex(ObjDictionary* dict, Value key) {
+    uint32_t hash = hashValue(key);
+    uint32_t index = hash & (dict->capacity - 1);
+    ObjString* transientKey = (IS_STRING(key) && !AS_STRING(key)->isInterned) ? AS_STRING(key) : NULL;
+    ObjEntry* tombstone = NULL;
+
+    for (;;) {
+        ObjEntry* entry = &dict->entries[index];
+        if (IS_UNDEFINED(entry->key)) {
+            if (IS_NIL(entry->value)) {
+                return -1;
+            }
+            else {
+                if (tombstone == NULL) tombstone = entry;
+            }
+        }
+        else if (entry->key == key || (transientKey != NULL && IS_STRING(entry->key) && stringsEqual(AS_STRING(entry->key), transientKey))) {
+            return index;
+        }
+
+        index = (index + 1) & (dict->capacity - 1);
+    }
+}
+
 void dictAdjustCapacity(VM* vm, ObjDictionary* dict, int capacity) {
     ObjEntry* entries = ALLOCATE(ObjEntry, capacity, dict->obj.generation);
     for (int i = 0; i < capacity; i++) {
@@ -59,6 +85,7 @@ bool dictGet(ObjDictionary* dict, Value key, Value* value) {
 }
 
 bool dictSet(VM* vm, ObjDictionary* dict, Value key, Value value) {
+    if (IS_STRING(key) && !AS_STRING(key)->isInterned) key = OBJ_VAL(internString(vm, AS_STRING(key)));
     if (dict->count + 1 > dict->capacity * TABLE_MAX_LOAD) {
         int capacity = GROW_CAPACITY(dict->capacity);
         dictAdjustCapacity(vm, dict, capacity);
@@ -6,6 +6,7 @@
 #include "value.h"
 
 ObjEntry* dictFindEntry(ObjEntry* entries, int capacity, Value key);
+int dictFindIndex(ObjDictionary* dict, Value key);
 void dictAdjustCapacity(VM* vm, ObjDictionary* dict, int capacity);
 bool dictGet(ObjDictionary* dict, Value key, Value* value);
 bool dictSet(VM* vm, ObjDictionary* dict, Value key, Value value);
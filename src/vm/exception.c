@@ -35,8 +35,11 @@ bool propagateException(VM* vm, bool isPromise) {
             }
         }
 
-        for (int i = 0; i <= frame->closure->function->arity + 1; i++) {
-            pop(vm);
+        if (frame->continuation != NULL) vm->stackTop = frame->nativeSlots;
+        else {
+            for (int i = 0; i <= frame->closure->function->arity + 1; i++) {
+                pop(vm);
+            }
         }
         push(vm, value);
 
@@ -304,7 +304,7 @@ void fileOnReadLine(uv_fs_t* fsRead) {
         data->file->offset += numReadLine;
     }
 
-    ObjString* string = takeString(data->vm, data->buffer.base, numReadLine);
+    ObjString* string = takeStringTransient(data->vm, data->buffer.base, numReadLine);
     promiseFulfill(data->vm, data->promise, OBJ_VAL(string));
     LOOP_POP_DATA(data);
 }
@@ -315,7 +315,7 @@ void fileOnReadString(uv_fs_t* fsRead) {
     int numRead = (int)fsRead->result;
     if (numRead > 0) data->file->offset += numRead;
     
-    ObjString* string = takeString(data->vm, data->buffer.base, numRead);
+    ObjString* string = takeStringTransient(data->vm, data->buffer.base, numRead);
     promiseFulfill(data->vm, data->promise, OBJ_VAL(string));
     LOOP_POP_DATA(data);
 }
@@ -363,8 +363,7 @@ ObjString* fileRead(VM* vm, ObjFile* file, bool isPeek) {
     int numRead = uv_fs_read(vm->eventLoop, file->fsRead, (uv_file)file->fsOpen->result, &uvBuf, 1, file->offset, NULL);
     if (numRead == 0) return NULL;
     if (!isPeek) file->offset += 1;
-    char ch[2] = { c, '\0' };
-    return copyString(vm, ch, 1);
+    return charString(vm, c);
 }
 
 ObjPromise* fileReadAsync(VM* vm, ObjFile* file, uv_fs_cb callback) {
@@ -424,7 +423,7 @@ ObjString* fileReadLine(VM* vm, ObjFile* file) {
         memcpy(line, uvBuf.base, lineOffset);
         line[lineOffset] = '\0';
         file->offset += lineOffset;
-        return takeString(vm, line, (int)lineOffset);
+        return takeStringTransient(vm, line, (int)lineOffset);
     }
     else return NULL;
 }
@@ -434,7 +433,7 @@ ObjString* fileReadString(VM* vm, ObjFile* file, int length) {
     uv_buf_t uvBuf = uv_buf_init(chars, length);
     int numRead = uv_fs_read(vm->eventLoop, file->fsRead, (uv_file)file->fsOpen->result, &uvBuf, 1, file->offset, NULL);
     if (numRead == 0) return NULL;
-    return takeString(vm, chars, (int)numRead);
+    return takeStringTransient(vm, chars, (int)numRead);
 }
 
 ObjPromise* fileReadStringAsync(VM* vm, ObjFile* file, size_t length, uv_fs_cb callback) {
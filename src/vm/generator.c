@@ -2,9 +2,23 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "memory.h"
 #include "object.h"
 #include "vm.h"
 
+static void growFrameSlots(VM* vm, ObjFrame* frame, int slotCount) {
+    int capacity = GROW_CAPACITY(frame->slotCapacity);
+    while (capacity < slotCount) capacity = GROW_CAPACITY(capacity);
+
+    if (hasInlineSlots(frame)) {
+        Value* slots = ALLOCATE(Value, capacity, frame->obj.generation);
+        memcpy(slots, frame->slots, sizeof(Value) * frame->slotCount);
+        frame->slots = slots;
+    }
+    else frame->slots = GROW_ARRAY(Value, frame->slots, frame->slotCapacity, capacity, frame->obj.generation);
+    frame->slotCapacity = capacity;
+}
+
 void initGenerator(VM* vm, ObjGenerator* generator, Value callee, ObjArray* arguments) {
     ObjClosure* closure = AS_CLOSURE(IS_BOUND_METHOD(callee) ? AS_BOUND_METHOD(callee)->method : callee);
     for (int i = 0; i < arguments->elements.count; i++) {
@@ -27,36 +41,55 @@ void initGenerator(VM* vm, ObjGenerator* generator, Value callee, ObjArray* argu
 
 void resumeGenerator(VM* vm, ObjGenerator* generator) {
     vm->apiStackDepth++;
+    Value* slots = vm->stackTop - 1;
     Value result = callGenerator(vm, generator);
-    vm->stackTop -= generator->frame->slotCount;
+    vm->stackTop = slots;
     push(vm, OBJ_VAL(generator));
     vm->apiStackDepth--;
     generator->value = result;
 }
 
 void loadGeneratorFrame(VM* vm, ObjGenerator* generator) {
+    ObjFrame* generatorFrame = generator->frame;
     CallFrame* frame = &vm->frames[vm->frameCount++];
-    frame->closure = generator->frame->closure;
-    frame->ip = generator->frame->ip;
+    frame->closure = generatorFrame->closure;
+    frame->ip = generatorFrame->ip;
     frame->slots = vm->stackTop - 1;
-    frame->slots[0] = generator->frame->slots[0];
+    frame->continuation = NULL;
+    frame->handlerCount = generatorFrame->handlerCount;
 
-    for (int i = 1; i < generator->frame->slotCount; i++) {
-        push(vm, generator->frame->slots[i]);
+    if (generatorFrame->handlerCount > 0) {
+        memcpy(frame->handlerStack, generatorFrame->handlerStack, sizeof(ExceptionHandler) * generatorFrame->handlerCount);
+    }
+    if (generatorFrame->slotCount > 0) {
+        memcpy(frame->slots, generatorFrame->slots, sizeof(Value) * generatorFrame->slotCount);
+        vm->stackTop = frame->slots + generatorFrame->slotCount;
     }
     if (generator->state != GENERATOR_START) push(vm, generator->value);
     generator->state = GENERATOR_RESUME;
 }
 
 void saveGeneratorFrame(VM* vm, ObjGenerator* generator, CallFrame* frame, Value result) {
-    generator->frame->closure = frame->closure;
-    generator->frame->ip = frame->ip;
+    ObjFrame* generatorFrame = generator->frame;
+    int slotCount = (int)(vm->stackTop - 1 - frame->slots);
+    if (slotCount > generatorFrame->slotCapacity) growFrameSlots(vm, generatorFrame, slotCount);
+    if (frame->handlerCount > 0 && generatorFrame->handlerStack == NULL) {
+        generatorFrame->handlerStack = ALLOCATE(ExceptionHandler, UINT4_MAX, generatorFrame->obj.generation);
+    }
+
+    generatorFrame->closure = frame->closure;
+    generatorFrame->ip = frame->ip;
+    generatorFrame->slotCount = slotCount;
+    generatorFrame->handlerCount = frame->handlerCount;
     generator->state = GENERATOR_YIELD;
     generator->value = result;
 
-    generator->frame->slotCount = 0;
-    for (Value* slot = frame->slots; slot < vm->stackTop - 1; slot++) {
-        generator->frame->slots[generator->frame->slotCount++] = *slot;
+    memcpy(generatorFrame->slots, frame->slots, sizeof(Value) * slotCount);
+    for (int i = 0; i < slotCount; i++) {
+        PROCESS_WRITE_BARRIER((Obj*)generatorFrame, generatorFrame->slots[i]);
+    }
+    if (frame->handlerCount > 0) {
+        memcpy(generatorFrame->handlerStack, frame->handlerStack, sizeof(ExceptionHandler) * frame->handlerCount);
     }
 }
 
@@ -2,48 +2,123 @@
 
 #include "hash.h"
 
+static inline uint64_t hashRead64(const uint8_t* bytes) {
+    uint64_t value;
+    memcpy(&value, bytes, sizeof(uint64_t));
+    return value;
+}
+
+static inline uint64_t hashRead32(const uint8_t* bytes) {
+    uint32_t value;
+    memcpy(&value, bytes, sizeof(uint32_t));
+    return value;
+}
+
+static inline uint64_t hashRead3(const uint8_t* bytes, size_t length) {
+    return ((uint64_t)bytes[0] << 16) | ((uint64_t)bytes[length >> 1] << 8) | bytes[length - 1];
+}
+
+static inline void hashMultiply(uint64_t* a, uint64_t* b) {
+#ifdef __SIZEOF_INT128__
+    __uint128_t product = (__uint128_t)*a * *b;
+    *a = (uint64_t)product;
+    *b = (uint64_t)(product >> 64);
+#else
+    uint64_t aHigh = *a >> 32, aLow = (uint32_t)*a, bHigh = *b >> 32, bLow = (uint32_t)*b;
+    uint64_t high = aHigh * bHigh, middle0 = aHigh * bLow, middle1 = aLow * bHigh, low = aLow * bLow;
+    uint64_t total = low + (middle0 << 32);
+    uint64_t carry = total < low;
+    uint64_t lowResult = total + (middle1 << 32);
+    carry += lowResult < total;
+    *a = lowResult;
+    *b = high + (middle0 >> 32) + (middle1 >> 32) + carry;
+#endif
+}
+
+static inline uint64_t hashMix(uint64_t a, uint64_t b) {
+    hashMultiply(&a, &b);
+    return a ^ b;
+}
+
 uint32_t hashString(const char* chars, int length) {
-    uint32_t hash = 2166136261u;
-    for (int i = 0; i < length; i++) {
-        hash ^= (uint8_t)chars[i];
-        hash *= 16777619;
+    const uint8_t* bytes = (const uint8_t*)chars;
+    size_t remaining = (size_t)length;
+    uint64_t seed = hashMix(HASH_SEED ^ HASH_SECRET0, HASH_SECRET1);
+    uint64_t a, b;
+
+    if (remaining <= 16) {
+        if (remaining >= 4) {
+            size_t offset = (remaining >> 3) << 2;
+            a = (hashRead32(bytes) << 32) | hashRead32(bytes + offset);
+            b = (hashRead32(bytes + remaining - 4) << 32) | hashRead32(bytes + remaining - 4 - offset);
+        }
+        else if (remaining > 0) {
+            a = hashRead3(bytes, remaining);
+            b = 0;
+        }
+        else a = b = 0;
     }
-    return hash;
+    else {
+        if (remaining > 48) {
+            uint64_t seed1 = seed, seed2 = seed;
+            do {
+                seed = hashMix(hashRead64(bytes) ^ HASH_SECRET1, hashRead64(bytes + 8) ^ seed);
+                seed1 = hashMix(hashRead64(bytes + 16) ^ HASH_SECRET2, hashRead64(bytes + 24) ^ seed1);
+                seed2 = hashMix(hashRead64(bytes + 32) ^ HASH_SECRET3, hashRead64(bytes + 40) ^ seed2);
+                bytes += 48;
+                remaining -= 48;
+            } while (remaining > 48);
+            seed ^= seed1 ^ seed2;
+        }
+
+        while (remaining > 16) {
+            seed = hashMix(hashRead64(bytes) ^ HASH_SECRET1, hashRead64(bytes + 8) ^ seed);
+            bytes += 16;
+            remaining -= 16;
+        }
+        a = hashRead64(bytes + remaining - 16);
+        b = hashRead64(bytes + remaining - 8);
+    }
+
+    a ^= HASH_SECRET1;
+    b ^= seed;
+    hashMultiply(&a, &b);
+    uint64_t hash = hashMix(a ^ HASH_SECRET0 ^ (uint64_t)length, b ^ HASH_SECRET1);
+    return (uint32_t)(hash ^ (hash >> 32));
 }
 
 uint32_t hashObject(Obj* object) {
     switch (object->type) {
         case OBJ_ARRAY: { 
             ObjArray* array = (ObjArray*)object;
-            int hash = 7;
+            uint32_t hash = 7;
             for (int i = 0; i < array->elements.count; i++) {
-                hash = hash * 31 + hashValue(array->elements.values[i]);
+                hash = hashCombine(hash, hashValue(array->elements.values[i]));
             }
             return hash;
         }
         case OBJ_CLASS: {
             ObjClass* klass = (ObjClass*)object;
-            int hash = 7;
-            hash = hash * 31 + hashValue(OBJ_VAL(klass->namespace->fullName));
-            hash = hash * 31 + hashValue(OBJ_VAL(klass->name));
+            uint32_t hash = 7;
+            hash = hashCombine(hash, hashValue(OBJ_VAL(klass->namespace->fullName)));
+            hash = hashCombine(hash, hashValue(OBJ_VAL(klass->name)));
             return hash;
         }
         case OBJ_DICTIONARY: { 
             ObjDictionary* dict = (ObjDictionary*)object;
-            int hash = 7;
+            uint32_t hash = 7;
             for (int i = 0; i < dict->capacity; i++) {
                 ObjEntry* entry = &dict->entries[i];
                 if (IS_UNDEFINED(entry->key)) continue;
-                hash = hash * 31 + hashValue(entry->key);
-                hash = hash * 31 + hashValue(entry->value);
+                hash += hashCombine(hashValue(entry->key), hashValue(entry->value));
             }
             return hash;
         }
         case OBJ_ENTRY: { 
             ObjEntry* entry = (ObjEntry*)object;
-            int hash = 7;
-            hash = hash * 31 + hashValue(entry->key);
-            hash = hash * 31 + hashValue(entry->value);
+            uint32_t hash = 7;
+            hash = hashCombine(hash, hashValue(entry->key));
+            hash = hashCombine(hash, hashValue(entry->value));
             return hash;
         }
         case OBJ_FUNCTION: {
@@ -52,10 +127,10 @@ uint32_t hashObject(Obj* object) {
         }
         case OBJ_INSTANCE: { 
             ObjInstance* instance = (ObjInstance*)object;
-            int hash = 7;
-            hash = hash * 31 + hashValue(INT_VAL(instance->obj.shapeID));
+            uint32_t hash = 7;
+            hash = hashCombine(hash, hashValue(INT_VAL(instance->obj.shapeID)));
             for (int i = 0; i < instance->fields.count; i++) {
-                hash = hash * 31 + hashValue(instance->fields.values[i]);
+                hash = hashCombine(hash, hashValue(instance->fields.values[i]));
             }
             return hash;
         }
@@ -64,9 +139,9 @@ uint32_t hashObject(Obj* object) {
             return hashNumber((double)range->from) ^ hashNumber((double)range->to);
         }
         case OBJ_STRING:
-            return ((ObjString*)object)->hash;
+            return hashObjString((ObjString*)object);
         default: {
-            uint64_t hash = (uint64_t)(&object);
+            uint64_t hash = (uint64_t)(uintptr_t)object;
             return hash64To32Bits(hash);
         }
     }
@@ -5,6 +5,12 @@
 #include "object.h"
 #include "value.h"
 
+#define HASH_SEED 0x2d358dccaa6c78a5ull
+#define HASH_SECRET0 0xa0761d6478bd642full
+#define HASH_SECRET1 0xe7037ed1a0b428dbull
+#define HASH_SECRET2 0x8ebc6af09c88c6e3ull
+#define HASH_SECRET3 0x589965cc75374cc3ull
+
 uint32_t hashString(const char* chars, int length);
 uint32_t hashObject(Obj* object);
 uint32_t hashValue(Value value);
@@ -19,8 +25,17 @@ static inline uint32_t hash64To32Bits(uint64_t hash) {
     return (uint32_t)(hash & 0x3fffffff);
 }
 
+static inline uint32_t hashCombine(uint32_t hash, uint32_t value) {
+    return hash64To32Bits(((uint64_t)hash << 32) | value);
+}
+
 static inline uint32_t hashNumber(double num) {
     return hash64To32Bits(numToValue(num));
 }
 
+static inline uint32_t hashObjString(ObjString* string) {
+    if (string->hash == 0) string->hash = hashString(string->chars, string->length);
+    return string->hash;
+}
+
 #endif // !clox_hash_h
\ No newline at end of file
@@ -118,7 +118,7 @@ ObjArray* httpCreateCookies(VM* vm, CURL* curl) {
 }
 
 ObjArray* httpCreateHeaders(VM* vm, CURLResponse curlResponse) {
-    ObjString* headerString = copyString(vm, curlResponse.headers, (int)curlResponse.hSize);
+    ObjString* headerString = copyStringTransient(vm, curlResponse.headers, (int)curlResponse.hSize);
     ObjArray* headers = newArray(vm);
     int startIndex = 0;
     push(vm, OBJ_VAL(headers));
@@ -142,7 +142,7 @@ ObjInstance* httpCreateResponse(VM* vm, ObjString* url, CURL* curl, CURLResponse
     ObjInstance* httpResponse = newInstance(vm, getNativeClass(vm, "clox.std.net.HTTPResponse"));
     push(vm, OBJ_VAL(httpResponse));
 
-    setObjProperty(vm, httpResponse, "content", OBJ_VAL(copyString(vm, curlResponse.content, (int)curlResponse.cSize)));
+    setObjProperty(vm, httpResponse, "content", OBJ_VAL(copyStringTransient(vm, curlResponse.content, (int)curlResponse.cSize)));
     setObjProperty(vm, httpResponse, "contentType", OBJ_VAL(newString(vm, contentType)));
     setObjProperty(vm, httpResponse, "cookies", OBJ_VAL(httpCreateCookies(vm, curl)));
     setObjProperty(vm, httpResponse, "headers", OBJ_VAL(httpCreateHeaders(vm, curlResponse)));
@@ -1,8 +1,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "hash.h"
 #include "id.h"
 #include "memory.h"
+#include "string.h"
 
 void initIDMap(IDMap* idMap, GCGenerationType generation) {
     idMap->count = 0;
@@ -16,11 +18,16 @@ void freeIDMap(VM* vm, IDMap* idMap) {
     initIDMap(idMap, idMap->generation);
 }
 
+static bool isTransientKey(ObjString* key) {
+    return key->obj.type == OBJ_STRING && !key->isInterned;
+}
+
 static IDEntry* findIDEntry(IDEntry* entries, int capacity, ObjString* key) {
-    uint32_t index = key->hash & (capacity - 1);
+    bool isTransient = isTransientKey(key);
+    uint32_t index = (isTransient ? hashObjString(key) : key->hash) & (capacity - 1);
     for (;;) {
         IDEntry* entry = &entries[index];
-        if (entry->key == key || entry->key == NULL) {
+        if (entry->key == key || entry->key == NULL || (isTransient && stringsEqual(entry->key, key))) {
             return entry;
         }
         index = (index + 1) & (capacity - 1);
@@ -61,6 +68,7 @@ static void idMapAdjustCapacity(VM* vm, IDMap* idMap, int capacity) {
 }
 
 bool idMapSet(VM* vm, IDMap* idMap, ObjString* key, int index) {
+    if (isTransientKey(key)) key = internString(vm, key);
     if (idMap->count + 1 > idMap->capacity * TABLE_MAX_LOAD) {
         int capacity = GROW_CAPACITY(idMap->capacity);
         idMapAdjustCapacity(vm, idMap, capacity);
@@ -84,6 +92,12 @@ void idMapAddAll(VM* vm, IDMap* from, IDMap* to) {
     }
 }
 
+void idMapShrink(VM* vm, IDMap* idMap, int capacity) {
+    if (capacity >= idMap->capacity) return;
+    if (capacity == 0) freeIDMap(vm, idMap);
+    else idMapAdjustCapacity(vm, idMap, capacity);
+}
+
 void markIDMap(VM* vm, IDMap* idMap, GCGenerationType generation) {
     for (int i = 0; i < idMap->capacity; i++) {
         IDEntry* entry = &idMap->entries[i];
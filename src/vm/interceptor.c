@@ -12,25 +12,32 @@ static bool isInterceptorMethod(ObjString* name) {
         name->chars[name->length - 1] == '_' && name->chars[name->length - 2] == '_');
 }
 
-void handleInterceptorMethod(VM* vm, ObjClass* klass, ObjString* name) {
-    if (!isInterceptorMethod(name)) return;
+static InterceptorType getInterceptorType(ObjString* name) {
+    if (strcmp(name->chars, "__init__") == 0) return INTERCEPTOR_INIT;
+    else if (strcmp(name->chars, "__beforeGet__") == 0) return INTERCEPTOR_BEFORE_GET;
+    else if (strcmp(name->chars, "__afterGet__") == 0) return INTERCEPTOR_AFTER_GET;
+    else if (strcmp(name->chars, "__beforeSet__") == 0) return INTERCEPTOR_BEFORE_SET;
+    else if (strcmp(name->chars, "__afterSet__") == 0) return INTERCEPTOR_AFTER_SET;
+    else if (strcmp(name->chars, "__onInvoke__") == 0) return INTERCEPTOR_ON_INVOKE;
+    else if (strcmp(name->chars, "__onReturn__") == 0) return INTERCEPTOR_ON_RETURN;
+    else if (strcmp(name->chars, "__onThrow__") == 0) return INTERCEPTOR_ON_THROW;
+    else if (strcmp(name->chars, "__onYield__") == 0) return INTERCEPTOR_ON_YIELD;
+    else if (strcmp(name->chars, "__onAwait__") == 0) return INTERCEPTOR_ON_AWAIT;
+    else if (strcmp(name->chars, "__undefinedGet__") == 0) return INTERCEPTOR_UNDEFINED_GET;
+    else if (strcmp(name->chars, "__undefinedInvoke__") == 0) return INTERCEPTOR_UNDEFINED_INVOKE;
+    else return INTERCEPTOR_NONE;
+}
 
-    else if (strcmp(name->chars, "__init__") == 0) SET_CLASS_INTERCEPTOR(klass, INTERCEPTOR_INIT);
-    else if (strcmp(name->chars, "__beforeGet__") == 0) SET_CLASS_INTERCEPTOR(klass, INTERCEPTOR_BEFORE_GET);
-    else if (strcmp(name->chars, "__afterGet__") == 0) SET_CLASS_INTERCEPTOR(klass, INTERCEPTOR_AFTER_GET);
-    else if (strcmp(name->chars, "__beforeSet__") == 0) SET_CLASS_INTERCEPTOR(klass, INTERCEPTOR_BEFORE_SET);
-    else if (strcmp(name->chars, "__afterSet__") == 0) SET_CLASS_INTERCEPTOR(klass, INTERCEPTOR_AFTER_SET);
-    else if (strcmp(name->chars, "__onInvoke__") == 0) SET_CLASS_INTERCEPTOR(klass, INTERCEPTOR_ON_INVOKE);
-    else if (strcmp(name->chars, "__onReturn__") == 0) SET_CLASS_INTERCEPTOR(klass, INTERCEPTOR_ON_RETURN);
-    else if (strcmp(name->chars, "__onThrow__") == 0) SET_CLASS_INTERCEPTOR(klass, INTERCEPTOR_ON_THROW);
-    else if (strcmp(name->chars, "__onYield__") == 0) SET_CLASS_INTERCEPTOR(klass, INTERCEPTOR_ON_YIELD);
-    else if (strcmp(name->chars, "__onAwait__") == 0) SET_CLASS_INTERCEPTOR(klass, INTERCEPTOR_ON_AWAIT);
-    else if (strcmp(name->chars, "__undefinedGet__") == 0) SET_CLASS_INTERCEPTOR(klass, INTERCEPTOR_UNDEFINED_GET);
-    else if (strcmp(name->chars, "__undefinedInvoke__") == 0) SET_CLASS_INTERCEPTOR(klass, INTERCEPTOR_UNDEFINED_INVOKE);
-    else {
+void handleInterceptorMethod(VM* vm, ObjClass* klass, ObjString* name, Value method) {
+    if (!isInterceptorMethod(name)) return;
+    InterceptorType type = getInterceptorType(name);
+    if (type == INTERCEPTOR_NONE) {
         runtimeError(vm, "Invalid interceptor method specified.");
         exit(70);
     }
+
+    SET_CLASS_INTERCEPTOR(klass, type);
+    if (IS_CLOSURE(method)) AS_CLOSURE(method)->function->interceptor = type;
 }
 
 bool hasInterceptableMethod(VM* vm, Value receiver, ObjString* name) {
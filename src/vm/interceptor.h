@@ -7,6 +7,10 @@
 #define HAS_CLASS_INTERCEPTOR(klass, interceptor) ((klass->interceptors) & (1 << interceptor))
 #define SET_CLASS_INTERCEPTOR(klass, interceptor) (klass->interceptors = (klass->interceptors) | (1 << interceptor))
 #define HAS_OBJ_INTERCEPTOR(object, interceptor) (IS_OBJ(object) && HAS_CLASS_INTERCEPTOR(AS_OBJ(object)->klass, interceptor))
+#define HAS_OBJ_INTERCEPTORS(object, mask) (IS_OBJ(object) && ((AS_OBJ(object)->klass->interceptors) & (mask)))
+
+#define INTERCEPTOR_GET_MASK ((1 << INTERCEPTOR_BEFORE_GET) | (1 << INTERCEPTOR_AFTER_GET) | (1 << INTERCEPTOR_UNDEFINED_GET))
+#define INTERCEPTOR_SET_MASK ((1 << INTERCEPTOR_BEFORE_SET) | (1 << INTERCEPTOR_AFTER_SET))
 
 typedef enum {
     INTERCEPTOR_INIT,
@@ -20,10 +24,11 @@ typedef enum {
     INTERCEPTOR_ON_YIELD,
     INTERCEPTOR_ON_AWAIT,
     INTERCEPTOR_UNDEFINED_GET,
-    INTERCEPTOR_UNDEFINED_INVOKE
+    INTERCEPTOR_UNDEFINED_INVOKE,
+    INTERCEPTOR_NONE
 } InterceptorType;
 
-void handleInterceptorMethod(VM* vm, ObjClass* klass, ObjString* name);
+void handleInterceptorMethod(VM* vm, ObjClass* klass, ObjString* name, Value method);
 bool hasInterceptableMethod(VM* vm, Value receiver, ObjString* name);
 bool interceptBeforeGet(VM* vm, Value receiver, ObjString* name);
 bool interceptAfterGet(VM* vm, Value receiver, ObjString* name, Value value);
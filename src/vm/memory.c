@@ -1,8 +1,13 @@
 #include <stdlib.h>
+#include <string.h>
 
 #include "hash.h"
 #include "memory.h"
 
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
 #ifdef DEBUG_LOG_GC
 #include <stdio.h>
 #include "debug.h"
@@ -10,10 +15,50 @@
 
 #pragma warning(disable : 33010)
 
+static bool isSweeperThread(GCSweeper* sweeper) {
+    if (sweeper == NULL || !sweeper->isRunning) return false;
+    uv_thread_t self = uv_thread_self();
+    return uv_thread_equal(&self, &sweeper->thread);
+}
+
+static void* reallocateLargeObject(VM* vm, void* pointer, size_t oldSize, size_t newSize, GCGenerationType generation) {
+    GCLargeObjectSpace* largeObjects = &vm->gc->largeObjects;
+    GCGeneration* currentHeap = GET_GC_GENERATION(generation);
+    if (IS_LARGE_OBJECT(oldSize)) largeObjects->bytesAllocated -= oldSize;
+    else currentHeap->bytesAllocated -= oldSize;
+
+    if (IS_LARGE_OBJECT(newSize)) {
+        largeObjects->bytesAllocated += newSize;
+        if (newSize > oldSize && !vm->gc->isCompacting && !vm->gc->isCollecting && largeObjects->bytesAllocated > largeObjects->heapSize) {
+            collectGarbage(vm, GC_GENERATION_TYPE_OLD);
+        }
+    }
+    else currentHeap->bytesAllocated += newSize;
+
+    if (newSize == 0) {
+        free(pointer);
+        return NULL;
+    }
+
+    void* result = realloc(pointer, newSize);
+    if (result == NULL) exit(1);
+    return result;
+}
+
 void* reallocate(VM* vm, void* pointer, size_t oldSize, size_t newSize, GCGenerationType generation) {
+    if (newSize == 0 && isSweeperThread(vm->gc->sweeper)) {
+        if (IS_LARGE_OBJECT(oldSize)) vm->gc->sweeper->largeBytesSwept += oldSize;
+        free(pointer);
+        return NULL;
+    }
+
+    if (IS_LARGE_OBJECT(oldSize) || IS_LARGE_OBJECT(newSize)) {
+        return reallocateLargeObject(vm, pointer, oldSize, newSize, generation);
+    }
+
     GCGeneration* currentHeap = GET_GC_GENERATION(generation);
     currentHeap->bytesAllocated += newSize - oldSize;
-    if (newSize > oldSize && generation < GC_GENERATION_TYPE_PERMANENT) {
+    if (newSize > oldSize && generation < GC_GENERATION_TYPE_PERMANENT && !vm->gc->isCompacting && !vm->gc->isCollecting) {
 #ifdef DEBUG_STRESS_GC
         collectGarbage(vm, generation);
 #endif
@@ -51,6 +96,9 @@ static void initGCGenerations(GC* gc, size_t heapSizes[]) {
         if (gc->generations[i] != NULL) {
             gc->generations[i]->bytesAllocated = 0;
             gc->generations[i]->heapSize = heapSizes[i]; 
+            gc->generations[i]->initialHeapSize = heapSizes[i];
+            gc->generations[i]->growthCostPerByte = 0;
+            gc->generations[i]->isGrowthSaturated = false;
             gc->generations[i]->objects = NULL;
             gc->generations[i]->type = i;
             initGCRememberedSet(&gc->generations[i]->remSet, i);
@@ -69,11 +117,39 @@ static void freeGCGenerations(VM* vm) {
     }
 }
 
+static GCSweeper* newGCSweeper() {
+    GCSweeper* sweeper = (GCSweeper*)malloc(sizeof(GCSweeper));
+    if (sweeper != NULL && uv_mutex_init(&sweeper->mutex) == 0 && uv_cond_init(&sweeper->condition) == 0) {
+        sweeper->objects = NULL;
+        sweeper->isRunning = false;
+        sweeper->isTerminating = false;
+        sweeper->largeBytesSwept = 0;
+        sweeper->largeBytesFreed = 0;
+        return sweeper;
+    }
+
+    fprintf(stderr, "Not enough memory to allocate for background GC sweeper.");
+    exit(74);
+}
+
 GC* newGC(VM* vm) {
     GC* gc = (GC*)malloc(sizeof(GC));
     if (gc != NULL) {
         size_t heapSizes[] = { vm->config.gcEdenHeapSize, vm->config.gcYoungHeapSize, vm->config.gcOldHeapSize, vm->config.gcHeapSize };
         initGCGenerations(gc, heapSizes);
+        gc->largeObjects.bytesAllocated = 0;
+        gc->largeObjects.heapSize = vm->config.gcLargeHeapSize;
+        gc->largeObjects.threshold = vm->config.gcLargeObjectSize;
+        gc->sweeper = (vm->config.gcType != NULL && strcmp(vm->config.gcType, "backgroundFree") == 0) ? newGCSweeper() : NULL;
+        gc->allocationSites.count = 0;
+        gc->allocationSites.slotCapacity = 0;
+        gc->allocationSites.sites = NULL;
+        gc->allocationSites.slots = NULL;
+        gc->startTime = uv_hrtime();
+        gc->gcTime = 0;
+        gc->isCollecting = false;
+        gc->isCompacting = false;
+        gc->isCompactionPending = false;
         gc->grayCapacity = 0;
         gc->grayCount = 0;
         gc->grayStack = NULL;
@@ -86,12 +162,19 @@ GC* newGC(VM* vm) {
 
 void freeGC(VM* vm) {
     freeGCGenerations(vm);
+    free(vm->gc->allocationSites.sites);
+    free(vm->gc->allocationSites.slots);
+    if (vm->gc->sweeper != NULL) {
+        uv_mutex_destroy(&vm->gc->sweeper->mutex);
+        uv_cond_destroy(&vm->gc->sweeper->condition);
+        free(vm->gc->sweeper);
+    }
     free(vm->gc);
 }
 
 static GCRememberedEntry* findRememberedSetEntry(GCRememberedEntry* entries, int capacity, Obj* object) {
-    uint32_t hash = hashObject(object);
-    uint32_t index = (uint32_t)hash & ((uint32_t)capacity - 1);
+    uint32_t hash = hash64To32Bits((uint64_t)(uintptr_t)object);
+    uint32_t index = hash & ((uint32_t)capacity - 1);
     for (;;) {
         GCRememberedEntry* entry = &entries[index];
         if (entry->object == NULL || entry->object == object) {
@@ -152,7 +235,10 @@ static bool rememberedSetPutObject(VM* vm, GCRememberedSet* remSet, Obj* object)
 
 void addToRememberedSet(VM* vm, Obj* object, GCGenerationType generation) {
     GCRememberedSet* remSet = &vm->gc->generations[generation]->remSet;
+    bool wasCollecting = vm->gc->isCollecting;
+    vm->gc->isCollecting = true;
     rememberedSetPutObject(vm, remSet, object);
+    vm->gc->isCollecting = wasCollecting;
 }
 
 void markObject(VM* vm, Obj* object, GCGenerationType generation) {
@@ -190,11 +276,21 @@ static void markArray(VM* vm, ValueArray* array, GCGenerationType generation) {
     }
 }
 
+static void markModuleGlobals(VM* vm, ObjModule* module, GCGenerationType generation) {
+    markIDMap(vm, &module->valIndexes, generation);
+    markArray(vm, &module->valFields, generation);
+    markIDMap(vm, &module->varIndexes, generation);
+    markArray(vm, &module->varFields, generation);
+}
+
 static void markGlobals(VM* vm, GCGenerationType generation) {
-    markIDMap(vm, &vm->currentModule->valIndexes, generation);
-    markArray(vm, &vm->currentModule->valFields, generation);
-    markIDMap(vm, &vm->currentModule->varIndexes, generation);
-    markArray(vm, &vm->currentModule->varFields, generation);
+    if (vm->currentModule != NULL) markModuleGlobals(vm, vm->currentModule, generation);
+    for (int i = 0; i < vm->modules.capacity; i++) {
+        Entry* entry = &vm->modules.entries[i];
+        if (entry->key != NULL && IS_MODULE(entry->value) && AS_MODULE(entry->value) != vm->currentModule) {
+            markModuleGlobals(vm, AS_MODULE(entry->value), generation);
+        }
+    }
 }
 
 void markRememberedSet(VM* vm, GCGenerationType generation) {
@@ -205,26 +301,32 @@ void markRememberedSet(VM* vm, GCGenerationType generation) {
     }
 }
 
-static size_t sizeOfObject(Obj* object) {
+static size_t sizeOfBuffer(VM* vm, size_t size) {
+    return IS_LARGE_OBJECT(size) ? 0 : size;
+}
+
+static size_t sizeOfObject(VM* vm, Obj* object) {
     switch (object->type) {
         case OBJ_ARRAY: {
             ObjArray* array = (ObjArray*)object;
-            return sizeof(ObjArray) + sizeof(Value) * array->elements.capacity;
+            return sizeof(ObjArray) + sizeOfBuffer(vm, sizeof(Value) * array->elements.capacity);
         }
         case OBJ_BOUND_METHOD: 
             return sizeof(ObjBoundMethod);
         case OBJ_CLASS: {
             ObjClass* _class = (ObjClass*)object;
             return sizeof(ObjClass) + sizeof(Value) * _class->traits.capacity + sizeof(Value) * _class->fields.capacity
-                + sizeof(Entry) * _class->methods.capacity + sizeof(IDEntry) * _class->indexes.capacity; 
+                + sizeof(Entry) * _class->methods.capacity + sizeof(IDEntry) * _class->indexes.capacity
+                + sizeof(uint64_t) * _class->traitSetCount;
         }
         case OBJ_CLOSURE: {
             ObjClosure* closure = (ObjClosure*)object;
+            if (closure->borrowedCount > 0) return sizeOfBorrowedClosure(closure->borrowedCount);
             return sizeof(ObjClosure) + sizeof(ObjUpvalue) * closure->upvalueCount;
         }
         case OBJ_DICTIONARY: {
             ObjDictionary* dictionary = (ObjDictionary*)object;
-            return sizeof(ObjDictionary) + sizeof(ObjEntry) * dictionary->capacity;
+            return sizeof(ObjDictionary) + sizeOfBuffer(vm, sizeof(ObjEntry) * dictionary->capacity);
         }
         case OBJ_ENTRY: 
             return sizeof(ObjEntry);
@@ -233,7 +335,11 @@ static size_t sizeOfObject(Obj* object) {
         case OBJ_FILE:
             return sizeof(ObjFile) + sizeof(uv_fs_t) * 4;
         case OBJ_FRAME: {
-            return sizeof(ObjFrame);
+            ObjFrame* frame = (ObjFrame*)object;
+            size_t size = sizeof(ObjFrame) + sizeof(Value) * frame->inlineCapacity;
+            if (!hasInlineSlots(frame)) size += sizeof(Value) * frame->slotCapacity;
+            if (frame->handlerStack != NULL) size += sizeof(ExceptionHandler) * UINT4_MAX;
+            return size;
         }
         case OBJ_FUNCTION: {
             ObjFunction* function = (ObjFunction*)object;
@@ -245,7 +351,10 @@ static size_t sizeOfObject(Obj* object) {
             return sizeof(ObjGenerator);
         case OBJ_INSTANCE: {
             ObjInstance* instance = (ObjInstance*)object;
-            return sizeof(ObjInstance) + sizeof(Value) * instance->fields.capacity;
+            size_t size = sizeof(ObjInstance) + sizeof(Value) * instance->inlineCapacity;
+            if (!hasInlineFields(instance)) size += sizeof(Value) * instance->fields.capacity;
+            if (instance->indexes != NULL) size += sizeof(IDMap) + sizeof(IDEntry) * instance->indexes->capacity;
+            return size;
         }
         case OBJ_METHOD: 
             return sizeof(ObjMethod);
@@ -277,6 +386,10 @@ static size_t sizeOfObject(Obj* object) {
             }
             else return sizeof(ObjRecord);
         }
+        case OBJ_STRING: {
+            ObjString* string = (ObjString*)object;
+            return sizeOfBuffer(vm, sizeof(ObjString) + string->length + 1);
+        }
         case OBJ_TIMER: {
             ObjTimer* timer = (ObjTimer*)object;
             return sizeof(ObjTimer) + sizeof(uv_timer_t) + sizeof(timer->timer->data);
@@ -322,6 +435,7 @@ static void blackenObject(VM* vm, Obj* object, GCGenerationType generation) {
             markIDMap(vm, &klass->indexes, generation);
             markArray(vm, &klass->fields, generation);
             markTable(vm, &klass->methods, generation);
+            markValue(vm, klass->initializer, generation);
             break;
         }
         case OBJ_CLOSURE: {
@@ -329,6 +443,7 @@ static void blackenObject(VM* vm, Obj* object, GCGenerationType generation) {
             markObject(vm, (Obj*)closure->function, generation);
             markObject(vm, (Obj*)closure->module, generation);
             for (int i = 0; i < closure->upvalueCount; i++) {
+                if (isBorrowedUpvalue(closure, closure->upvalues[i])) continue;
                 markObject(vm, (Obj*)closure->upvalues[i], generation);
             }
             break;
@@ -338,7 +453,7 @@ static void blackenObject(VM* vm, Obj* object, GCGenerationType generation) {
             for (int i = 0; i < dict->capacity; i++) {
                 ObjEntry* entry = &dict->entries[i];
                 markValue(vm, entry->key, generation);
-                markObject(vm, (Obj*)entry, generation);
+                markValue(vm, entry->value, generation);
             }
             break;
         }
@@ -363,11 +478,15 @@ static void blackenObject(VM* vm, Obj* object, GCGenerationType generation) {
         case OBJ_FRAME: {
             ObjFrame* frame = (ObjFrame*)object;
             markObject(vm, (Obj*)frame->closure, generation);
+            for (int i = 0; i < frame->slotCount; i++) {
+                markValue(vm, frame->slots[i], generation);
+            }
             break;
         }
         case OBJ_FUNCTION: {
             ObjFunction* function = (ObjFunction*)object;
             markObject(vm, (Obj*)function->name, generation);
+            markObject(vm, (Obj*)function->closure, generation);
             markArray(vm, &function->chunk.constants, generation);
             markArray(vm, &function->chunk.identifiers, generation);
             break;
@@ -384,6 +503,7 @@ static void blackenObject(VM* vm, Obj* object, GCGenerationType generation) {
             ObjInstance* instance = (ObjInstance*)object;
             markObject(vm, (Obj*)object->klass, generation);
             markArray(vm, &instance->fields, generation);
+            if (instance->indexes != NULL) markIDMap(vm, instance->indexes, generation);
             break;
         }
         case OBJ_METHOD: {
@@ -485,6 +605,7 @@ static void freeObject(VM* vm, Obj* object) {
         case OBJ_CLASS: {
             ObjClass* klass = (ObjClass*)object;
             freeValueArray(vm, &klass->traits);
+            FREE_ARRAY(uint64_t, klass->traitSet, klass->traitSetCount, object->generation);
             freeIDMap(vm, &klass->indexes);
             freeValueArray(vm, &klass->fields);
             freeTable(vm, &klass->methods);
@@ -493,6 +614,10 @@ static void freeObject(VM* vm, Obj* object) {
         }
         case OBJ_CLOSURE: {
             ObjClosure* closure = (ObjClosure*)object;
+            if (closure->borrowedCount > 0) {
+                reallocate(vm, object, sizeOfBorrowedClosure(closure->borrowedCount), 0, object->generation);
+                break;
+            }
             FREE_ARRAY(ObjUpvalue*, closure->upvalues, closure->upvalueCount, closure->obj.generation);
             FREE(ObjClosure, object, object->generation);
             break;
@@ -533,7 +658,10 @@ static void freeObject(VM* vm, Obj* object) {
             break;
         }
         case OBJ_FRAME: {
-            FREE(ObjFrame, object, object->generation);
+            ObjFrame* frame = (ObjFrame*)object;
+            if (!hasInlineSlots(frame)) FREE_ARRAY(Value, frame->slots, frame->slotCapacity, object->generation);
+            if (frame->handlerStack != NULL) FREE_ARRAY(ExceptionHandler, frame->handlerStack, UINT4_MAX, object->generation);
+            reallocate(vm, object, sizeof(ObjFrame) + sizeof(Value) * frame->inlineCapacity, 0, object->generation);
             break;
         }
         case OBJ_FUNCTION: {
@@ -548,8 +676,12 @@ static void freeObject(VM* vm, Obj* object) {
         }
         case OBJ_INSTANCE: {
             ObjInstance* instance = (ObjInstance*)object;
-            freeValueArray(vm, &instance->fields);
-            FREE(ObjInstance, object, object->generation);
+            if (!hasInlineFields(instance)) freeValueArray(vm, &instance->fields);
+            if (instance->indexes != NULL) {
+                freeIDMap(vm, instance->indexes);
+                FREE(IDMap, instance->indexes, object->generation);
+            }
+            reallocate(vm, object, sizeof(ObjInstance) + sizeof(Value) * instance->inlineCapacity, 0, object->generation);
             break;
         }
         case OBJ_METHOD: {
@@ -620,66 +752,139 @@ static void freeObject(VM* vm, Obj* object) {
     }
 }
 
-static void promoteObject(VM* vm, Obj* object, GCGenerationType generation) {
-    GCGeneration* currentHeap = GET_GC_GENERATION(generation);
-    GCGeneration* nextHeap = GET_GC_GENERATION(generation + 1);
-    object->generation++;
+static void moveObject(VM* vm, Obj* object, GCGenerationType from, GCGenerationType to) {
+    GCGeneration* currentHeap = GET_GC_GENERATION(from);
+    GCGeneration* nextHeap = GET_GC_GENERATION(to);
+    object->generation = to;
     object->next = nextHeap->objects;
     nextHeap->objects = object;
 
     switch (object->type) {
         case OBJ_ARRAY: {
             ObjArray* array = (ObjArray*)object;
-            array->elements.generation++;
+            array->elements.generation = to;
             break;
         }
         case OBJ_CLASS: {
             ObjClass* _class = (ObjClass*)object;
-            _class->traits.generation++;
-            _class->indexes.generation++;
-            _class->fields.generation++;
-            _class->methods.generation++;
+            _class->traits.generation = to;
+            _class->indexes.generation = to;
+            _class->fields.generation = to;
+            _class->methods.generation = to;
             break;
         }
         case OBJ_FUNCTION: {
             ObjFunction* function = (ObjFunction*)object;
-            function->chunk.generation++;
-            function->chunk.constants.generation++;
-            function->chunk.identifiers.generation++;
+            function->chunk.generation = to;
+            function->chunk.constants.generation = to;
+            function->chunk.identifiers.generation = to;
             break;
         }
         case OBJ_INSTANCE: {
             ObjInstance* instance = (ObjInstance*)object;
-            instance->fields.generation++;
+            instance->fields.generation = to;
+            if (instance->indexes != NULL) instance->indexes->generation = to;
             break;
         }
         case OBJ_MODULE: {
             ObjModule* module = (ObjModule*)object;
-            module->valIndexes.generation++;
-            module->valFields.generation++;
-            module->varIndexes.generation++;
-            module->varFields.generation++;
+            module->valIndexes.generation = to;
+            module->valFields.generation = to;
+            module->varIndexes.generation = to;
+            module->varFields.generation = to;
             break;
         }
         case OBJ_NAMESPACE: {
             ObjNamespace* namespace = (ObjNamespace*)object;
-            namespace->values.generation++;
+            namespace->values.generation = to;
             break;
         }
         case OBJ_VALUE_INSTANCE: {
             ObjValueInstance* valueInstance = (ObjValueInstance*)object;
-            valueInstance->fields.generation++;
+            valueInstance->fields.generation = to;
             break;
         }
         default:
             break;
     }
 
-    size_t size = sizeOfObject(object);
+    size_t size = sizeOfObject(vm, object);
     currentHeap->bytesAllocated -= size;
     nextHeap->bytesAllocated += size;
 }
 
+static void promoteObject(VM* vm, Obj* object, GCGenerationType generation) {
+    moveObject(vm, object, generation, generation + 1);
+}
+
+static GCAllocationSite* findAllocationSite(VM* vm, uint8_t* ip) {
+    GCAllocationSiteMap* siteMap = &vm->gc->allocationSites;
+    if (siteMap->count + 1 > siteMap->slotCapacity * TABLE_MAX_LOAD) {
+        if (siteMap->count >= UINT16_MAX) return NULL;
+        int slotCapacity = GROW_CAPACITY(siteMap->slotCapacity);
+        uint16_t* slots = (uint16_t*)calloc(slotCapacity, sizeof(uint16_t));
+        GCAllocationSite* sites = (GCAllocationSite*)realloc(siteMap->sites, sizeof(GCAllocationSite) * slotCapacity);
+        if (slots == NULL || sites == NULL) {
+            fprintf(stderr, "Not enough memory to allocate for GC allocation sites.");
+            exit(74);
+        }
+
+        for (int i = 0; i < siteMap->count; i++) {
+            uint32_t index = hash64To32Bits((uint64_t)(uintptr_t)sites[i].ip) & (slotCapacity - 1);
+            while (slots[index] != 0) index = (index + 1) & (slotCapacity - 1);
+            slots[index] = (uint16_t)(i + 1);
+        }
+        free(siteMap->slots);
+        siteMap->slots = slots;
+        siteMap->sites = sites;
+        siteMap->slotCapacity = slotCapacity;
+    }
+
+    uint32_t index = hash64To32Bits((uint64_t)(uintptr_t)ip) & (siteMap->slotCapacity - 1);
+    for (;;) {
+        uint16_t siteID = siteMap->slots[index];
+        if (siteID == 0) break;
+        if (siteMap->sites[siteID - 1].ip == ip) return &siteMap->sites[siteID - 1];
+        index = (index + 1) & (siteMap->slotCapacity - 1);
+    }
+
+    GCAllocationSite* site = &siteMap->sites[siteMap->count++];
+    site->ip = ip;
+    site->id = (uint16_t)siteMap->count;
+    site->allocated = 0;
+    site->sampled = 0;
+    site->survived = 0;
+    site->isPretenured = false;
+    siteMap->slots[index] = site->id;
+    return site;
+}
+
+void trackAllocationSite(VM* vm, Obj* object, uint8_t* ip) {
+    if (ip == NULL || vm->config.gcPretenureRatio <= 0 || object->generation != GC_GENERATION_TYPE_EDEN) return;
+    GCAllocationSite* site = findAllocationSite(vm, ip);
+    if (site == NULL) return;
+
+    GCGeneration* eden = GET_GC_GENERATION(GC_GENERATION_TYPE_EDEN);
+    bool isSample = ++site->allocated % GC_PRETENURE_SAMPLE_INTERVAL == 0;
+    if (site->isPretenured && !isSample && eden->objects == object) {
+        eden->objects = object->next;
+        moveObject(vm, object, GC_GENERATION_TYPE_EDEN, GC_GENERATION_TYPE_OLD);
+    }
+    else object->siteID = site->id;
+}
+
+static void sampleAllocationSite(VM* vm, Obj* object) {
+    GCAllocationSite* site = &vm->gc->allocationSites.sites[object->siteID - 1];
+    site->sampled++;
+    if (object->isMarked) site->survived++;
+
+    if (site->sampled >= GC_PRETENURE_SAMPLE_SIZE) {
+        site->isPretenured = site->survived >= site->sampled * vm->config.gcPretenureRatio;
+        site->sampled = 0;
+        site->survived = 0;
+    }
+}
+
 static void markRoots(VM* vm, GCGenerationType generation) {
     for (Value* slot = vm->stack; slot < vm->stackTop; slot++) {
         markValue(vm, *slot, generation);
@@ -699,6 +904,7 @@ static void markRoots(VM* vm, GCGenerationType generation) {
 
     markGlobals(vm, generation);
     markRememberedSet(vm, generation);
+    markShapeProperties(vm, generation);
     markCompilerRoots(vm);
 }
 
@@ -709,13 +915,101 @@ static void traceReferences(VM* vm, GCGenerationType generation) {
     }
 }
 
+static void freeInBackground(void* data) {
+    VM* vm = (VM*)data;
+    GCSweeper* sweeper = vm->gc->sweeper;
+    uv_mutex_lock(&sweeper->mutex);
+
+    while (!sweeper->isTerminating) {
+        if (sweeper->objects == NULL) {
+            uv_cond_wait(&sweeper->condition, &sweeper->mutex);
+            continue;
+        }
+
+        Obj* object = sweeper->objects;
+        sweeper->objects = NULL;
+        uv_mutex_unlock(&sweeper->mutex);
+
+        while (object != NULL) {
+            Obj* unreached = object;
+            object = object->next;
+            freeObject(vm, unreached);
+        }
+
+        uv_mutex_lock(&sweeper->mutex);
+        sweeper->largeBytesFreed += sweeper->largeBytesSwept;
+        sweeper->largeBytesSwept = 0;
+    }
+    uv_mutex_unlock(&sweeper->mutex);
+}
+
+static bool canFreeInBackground(VM* vm, Obj* object, GCGenerationType generation) {
+    if (vm->gc->sweeper == NULL || generation != GC_GENERATION_TYPE_OLD) return false;
+    switch (object->type) {
+        case OBJ_FILE:
+        case OBJ_RECORD:
+        case OBJ_TIMER:
+            return false;
+        default:
+            return true;
+    }
+}
+
+static void handOffToSweeper(VM* vm, Obj* objects, Obj* lastObject) {
+    GCSweeper* sweeper = vm->gc->sweeper;
+    uv_mutex_lock(&sweeper->mutex);
+    if (!sweeper->isRunning) {
+        sweeper->isRunning = true;
+        if (uv_thread_create(&sweeper->thread, freeInBackground, vm) != 0) {
+            fprintf(stderr, "Failed to start background GC sweeper thread.");
+            exit(74);
+        }
+    }
+
+    lastObject->next = sweeper->objects;
+    sweeper->objects = objects;
+    uv_cond_signal(&sweeper->condition);
+    uv_mutex_unlock(&sweeper->mutex);
+}
+
+static void reclaimLargeBytes(VM* vm) {
+    GCSweeper* sweeper = vm->gc->sweeper;
+    if (sweeper == NULL) return;
+    uv_mutex_lock(&sweeper->mutex);
+    vm->gc->largeObjects.bytesAllocated -= sweeper->largeBytesFreed;
+    sweeper->largeBytesFreed = 0;
+    uv_mutex_unlock(&sweeper->mutex);
+}
+
+static void stopSweeper(VM* vm) {
+    GCSweeper* sweeper = vm->gc->sweeper;
+    if (sweeper == NULL || !sweeper->isRunning) return;
+    uv_mutex_lock(&sweeper->mutex);
+    sweeper->isTerminating = true;
+    uv_cond_signal(&sweeper->condition);
+    uv_mutex_unlock(&sweeper->mutex);
+    uv_thread_join(&sweeper->thread);
+    sweeper->isRunning = false;
+
+    Obj* object = sweeper->objects;
+    sweeper->objects = NULL;
+    while (object != NULL) {
+        Obj* next = object->next;
+        freeObject(vm, object);
+        object = next;
+    }
+}
+
 static void sweep(VM* vm, GCGenerationType generation) {
     GCGeneration* currentHeap = GET_GC_GENERATION(generation);
     GCGeneration* nextHeap = (generation >= GC_GENERATION_TYPE_PERMANENT) ? NULL : GET_GC_GENERATION(generation + 1);
     if (nextHeap == NULL) return;
     Obj* object = currentHeap->objects;
+    Obj* garbage = NULL;
+    Obj* lastGarbage = NULL;
 
     while (object != NULL) {
+        if (generation == GC_GENERATION_TYPE_EDEN && object->siteID != 0) sampleAllocationSite(vm, object);
         if (object->isMarked) {
             object->isMarked = false;
             Obj* reached = object;
@@ -725,15 +1019,107 @@ static void sweep(VM* vm, GCGenerationType generation) {
         else {
             Obj* unreached = object;
             object = object->next;
-            freeObject(vm, unreached);
+            if (unreached->type == OBJ_STRING && ((ObjString*)unreached)->isInterned) tableDelete(&vm->strings, (ObjString*)unreached);
+            if (canFreeInBackground(vm, unreached, generation)) {
+                currentHeap->bytesAllocated -= sizeOfObject(vm, unreached);
+                if (lastGarbage == NULL) lastGarbage = unreached;
+                unreached->next = garbage;
+                garbage = unreached;
+            }
+            else freeObject(vm, unreached);
         }
         currentHeap->objects = object;
     }
+
+    if (garbage != NULL) handOffToSweeper(vm, garbage, lastGarbage);
+}
+
+static size_t maxHeapSize(VM* vm, GCGenerationType generation) {
+    if (vm->config.gcMaxHeapBytes == 0) return SIZE_MAX;
+    size_t otherHeapSizes = 0;
+    for (GCGenerationType i = GC_GENERATION_TYPE_EDEN; i < GC_GENERATION_TYPE_PERMANENT; i++) {
+        if (i != generation) otherHeapSizes += GET_GC_GENERATION(i)->heapSize;
+    }
+    return (otherHeapSizes >= vm->config.gcMaxHeapBytes) ? GC_HEAP_MIN_SIZE : vm->config.gcMaxHeapBytes - otherHeapSizes;
+}
+
+static void resizeHeap(VM* vm, GCGenerationType generation, size_t bytesCollected, size_t bytesSurvived, uint64_t pauseTime) {
+    if (vm->config.gcThroughputGoal <= 0 || generation >= GC_GENERATION_TYPE_PERMANENT) return;
+    GCGeneration* currentHeap = GET_GC_GENERATION(generation);
+    vm->gc->gcTime += pauseTime;
+
+    uint64_t elapsedTime = uv_hrtime() - vm->gc->startTime;
+    double gcTimeRatio = (elapsedTime == 0) ? 0 : (double)vm->gc->gcTime / elapsedTime;
+    double gcTimeBudget = 1.0 - vm->config.gcThroughputGoal;
+    double survivalRate = (bytesCollected == 0) ? 0 : (double)bytesSurvived / bytesCollected;
+    double pauseMs = pauseTime / 1e6;
+    double costPerByte = (bytesCollected == 0) ? 0 : (double)pauseTime / bytesCollected;
+    bool isGrowthWasted = currentHeap->growthCostPerByte > 0 && costPerByte > currentHeap->growthCostPerByte * GC_HEAP_GROWTH_PAYOFF;
+    size_t heapSize = currentHeap->heapSize;
+    currentHeap->growthCostPerByte = 0;
+
+    if (vm->config.gcTargetPauseMs > 0 && pauseMs > vm->config.gcTargetPauseMs) {
+        heapSize = (size_t)(heapSize * (vm->config.gcTargetPauseMs / pauseMs));
+    }
+    else if (isGrowthWasted) {
+        heapSize /= GC_HEAP_GROW_FACTOR;
+        currentHeap->isGrowthSaturated = true;
+    }
+    else if ((gcTimeRatio > gcTimeBudget && !currentHeap->isGrowthSaturated) || survivalRate > GC_HIGH_SURVIVAL_RATE) {
+        heapSize *= GC_HEAP_GROW_FACTOR;
+        currentHeap->growthCostPerByte = costPerByte;
+    }
+    else if (gcTimeRatio < gcTimeBudget / 4 && survivalRate < GC_LOW_SURVIVAL_RATE && heapSize > currentHeap->initialHeapSize) {
+        heapSize /= GC_HEAP_GROW_FACTOR;
+    }
+
+    size_t maxSize = maxHeapSize(vm, generation);
+    size_t minSize = currentHeap->bytesAllocated + GC_HEAP_MIN_SIZE;
+    if (heapSize > maxSize) heapSize = maxSize;
+    if (heapSize < minSize) heapSize = minSize;
+    if (heapSize < GC_HEAP_MIN_SIZE) heapSize = GC_HEAP_MIN_SIZE;
+
+#ifdef DEBUG_LOG_GC
+    if (heapSize != currentHeap->heapSize) {
+        printf("   resized heap from %zu bytes to %zu bytes, survival rate %.2f, gc time ratio %.4f\n",
+            currentHeap->heapSize, heapSize, survivalRate, gcTimeRatio);
+    }
+#endif
+    currentHeap->heapSize = heapSize;
+}
+
+static void resizeLargeObjectSpace(VM* vm) {
+    if (vm->config.gcThroughputGoal <= 0) return;
+    GCLargeObjectSpace* largeObjects = &vm->gc->largeObjects;
+    size_t heapSize = largeObjects->bytesAllocated * GC_HEAP_GROW_FACTOR;
+    size_t maxSize = maxHeapSize(vm, GC_GENERATION_TYPE_PERMANENT);
+    size_t minSize = largeObjects->bytesAllocated + GC_HEAP_MIN_SIZE;
+    if (heapSize < vm->config.gcLargeHeapSize) heapSize = vm->config.gcLargeHeapSize;
+    if (heapSize > maxSize) heapSize = maxSize;
+    if (heapSize < minSize) heapSize = minSize;
+
+#ifdef DEBUG_LOG_GC
+    if (heapSize != largeObjects->heapSize) {
+        printf("   resized large object space from %zu bytes to %zu bytes\n", largeObjects->heapSize, heapSize);
+    }
+#endif
+    largeObjects->heapSize = heapSize;
+}
+
+static void resizeOldHeaps(VM* vm, size_t bytesCollected, size_t bytesSurvived, uint64_t pauseTime) {
+    resizeHeap(vm, GC_GENERATION_TYPE_OLD, bytesCollected, bytesSurvived, pauseTime);
+    resizeLargeObjectSpace(vm);
 }
 
 static void processRememberedSet(VM* vm, GCGenerationType generation) {
-    if (generation >= GC_GENERATION_TYPE_OLD) return;
     GCRememberedSet* currentRemSet = &GET_GC_GENERATION(generation)->remSet;
+    if (generation >= GC_GENERATION_TYPE_OLD) {
+        for (int i = 0; i < currentRemSet->capacity; i++) {
+            GCRememberedEntry* entry = &currentRemSet->entries[i];
+            if (entry->object != NULL) entry->object->isMarked = false;
+        }
+        return;
+    }
     GCRememberedSet* nextRemSet = &GET_GC_GENERATION(generation + 1)->remSet;
 
     for (int i = 0; i < currentRemSet->capacity; i++) {
@@ -749,22 +1135,34 @@ static void processRememberedSet(VM* vm, GCGenerationType generation) {
 }
 
 void collectGarbage(VM* vm, GCGenerationType generation) {
+    bool wasCollecting = vm->gc->isCollecting;
+    vm->gc->isCollecting = true;
     if (generation > 0) collectGarbage(vm, generation - 1);
+    reclaimLargeBytes(vm);
     GCGeneration* currentHeap = GET_GC_GENERATION(generation);
-
-#ifdef DEBUG_LOG_GC
-    printf("-- gc begin for generation %d\n", generation);
     GCGeneration* nextHeap = (generation >= GC_GENERATION_TYPE_PERMANENT) ? NULL : GET_GC_GENERATION(generation + 1);
     size_t currentBefore = currentHeap->bytesAllocated;
     size_t nextBefore = (nextHeap == NULL) ? 0 : nextHeap->bytesAllocated;
+    uint64_t pauseStart = uv_hrtime();
+
+#ifdef DEBUG_LOG_GC
+    printf("-- gc begin for generation %d\n", generation);
 #endif
 
     markRoots(vm, generation);
     traceReferences(vm, generation);
-    tableRemoveWhite(&vm->strings);
     sweep(vm, generation);
     processRememberedSet(vm, generation);
 
+    size_t bytesSurvived = (nextHeap == NULL || nextHeap->bytesAllocated < nextBefore) ? 0 : nextHeap->bytesAllocated - nextBefore;
+    uint64_t pauseTime = uv_hrtime() - pauseStart;
+    if (generation != GC_GENERATION_TYPE_OLD) resizeHeap(vm, generation, currentBefore, bytesSurvived, pauseTime);
+    else {
+        resizeOldHeaps(vm, currentBefore, bytesSurvived, pauseTime);
+        if (vm->config.gcOldCompactRatio > 0) vm->gc->isCompactionPending = true;
+    }
+    vm->gc->isCollecting = wasCollecting;
+
 #ifdef DEBUG_LOG_GC
     printf("-- gc end for generation %d\n", generation);
     size_t nextBytesAllocated = (nextHeap == NULL) ? 0 : nextHeap->bytesAllocated;
@@ -779,7 +1177,102 @@ void collectGarbage(VM* vm, GCGenerationType generation) {
 #endif
 }
 
+static int compactCapacity(int count) {
+    int capacity = 0;
+    while (capacity < count) capacity = GROW_CAPACITY(capacity);
+    return capacity;
+}
+
+static size_t compactValueArray(VM* vm, ValueArray* array, bool shouldShrink) {
+    int capacity = compactCapacity(array->count);
+    if (capacity >= array->capacity) return 0;
+    size_t slack = sizeof(Value) * (array->capacity - capacity);
+    if (shouldShrink) valueArrayShrink(vm, array, capacity);
+    return slack;
+}
+
+static size_t compactTable(VM* vm, Table* table, bool shouldShrink) {
+    int count = tableLiveCount(table);
+    int capacity = (count == 0) ? 0 : compactCapacity((int)((count + 1) / TABLE_MAX_LOAD) + 1);
+    if (capacity >= table->capacity) return 0;
+    size_t slack = sizeof(Entry) * (table->capacity - capacity);
+    if (shouldShrink) tableShrink(vm, table, capacity);
+    return slack;
+}
+
+static size_t compactIDMap(VM* vm, IDMap* idMap, bool shouldShrink) {
+    int capacity = (idMap->count == 0) ? 0 : compactCapacity((int)((idMap->count + 1) / TABLE_MAX_LOAD) + 1);
+    if (capacity >= idMap->capacity) return 0;
+    size_t slack = sizeof(IDEntry) * (idMap->capacity - capacity);
+    if (shouldShrink) idMapShrink(vm, idMap, capacity);
+    return slack;
+}
+
+static size_t compactObject(VM* vm, Obj* object, bool shouldShrink) {
+    switch (object->type) {
+        case OBJ_ARRAY:
+            return compactValueArray(vm, &((ObjArray*)object)->elements, shouldShrink);
+        case OBJ_CLASS: {
+            ObjClass* klass = (ObjClass*)object;
+            return compactValueArray(vm, &klass->traits, shouldShrink) + compactIDMap(vm, &klass->indexes, shouldShrink)
+                + compactValueArray(vm, &klass->fields, shouldShrink) + compactTable(vm, &klass->methods, shouldShrink);
+        }
+        case OBJ_INSTANCE: {
+            ObjInstance* instance = (ObjInstance*)object;
+            size_t slack = (instance->indexes != NULL) ? compactIDMap(vm, instance->indexes, shouldShrink) : 0;
+            if (hasInlineFields(instance)) return slack;
+            return slack + compactValueArray(vm, &instance->fields, shouldShrink);
+        }
+        case OBJ_MODULE: {
+            ObjModule* module = (ObjModule*)object;
+            return compactIDMap(vm, &module->valIndexes, shouldShrink) + compactValueArray(vm, &module->valFields, shouldShrink)
+                + compactIDMap(vm, &module->varIndexes, shouldShrink) + compactValueArray(vm, &module->varFields, shouldShrink);
+        }
+        case OBJ_NAMESPACE:
+            return compactTable(vm, &((ObjNamespace*)object)->values, shouldShrink);
+        case OBJ_PROMISE:
+            return compactValueArray(vm, &((ObjPromise*)object)->handlers, shouldShrink);
+        case OBJ_VALUE_INSTANCE:
+            return compactValueArray(vm, &((ObjValueInstance*)object)->fields, shouldShrink);
+        default:
+            return 0;
+    }
+}
+
+static size_t compactGenerations(VM* vm, bool shouldShrink) {
+    size_t slack = compactTable(vm, &vm->strings, shouldShrink);
+    for (uint64_t i = 0; i < vm->genericIDMap.count; i++) {
+        slack += compactValueArray(vm, &vm->genericIDMap.slots[i], shouldShrink);
+    }
+
+    for (int i = GC_GENERATION_TYPE_OLD; i < GC_GENERATION_TYPE_COUNT; i++) {
+        for (Obj* object = GET_GC_GENERATION(i)->objects; object != NULL; object = object->next) {
+            slack += compactObject(vm, object, shouldShrink);
+        }
+    }
+    return slack;
+}
+
+void compactHeap(VM* vm) {
+    vm->gc->isCompactionPending = false;
+    vm->gc->isCompacting = true;
+    size_t heapSize = GET_GC_GENERATION(GC_GENERATION_TYPE_OLD)->bytesAllocated + GET_GC_GENERATION(GC_GENERATION_TYPE_PERMANENT)->bytesAllocated;
+    size_t slack = compactGenerations(vm, false);
+
+    if (slack > heapSize * vm->config.gcOldCompactRatio) {
+#ifdef DEBUG_LOG_GC
+        printf("-- gc compact old generation, %zu bytes of slack\n", slack);
+#endif
+        compactGenerations(vm, true);
+#ifdef __GLIBC__
+        malloc_trim(0);
+#endif
+    }
+    vm->gc->isCompacting = false;
+}
+
 void freeObjects(VM* vm) {
+    stopSweeper(vm);
     for (int i = 0; i < GC_GENERATION_TYPE_COUNT; i++) {
         Obj* object = GET_GC_GENERATION(i)->objects;
         while (object != NULL) {
@@ -7,6 +7,13 @@
 #include "vm.h"
 
 #define GC_GENERATION_TYPE_COUNT 4
+#define GC_PRETENURE_SAMPLE_SIZE 64
+#define GC_PRETENURE_SAMPLE_INTERVAL 16
+#define GC_HEAP_GROW_FACTOR 2
+#define GC_HEAP_MIN_SIZE 262144
+#define GC_HEAP_GROWTH_PAYOFF 0.8
+#define GC_HIGH_SURVIVAL_RATE 0.5
+#define GC_LOW_SURVIVAL_RATE 0.1
 
 typedef struct {
     Obj* object;
@@ -25,10 +32,54 @@ typedef struct {
     GCRememberedSet remSet;
     size_t bytesAllocated;
     size_t heapSize;
+    size_t initialHeapSize;
+    double growthCostPerByte;
+    bool isGrowthSaturated;
 } GCGeneration;
 
+typedef struct {
+    size_t bytesAllocated;
+    size_t heapSize;
+    size_t threshold;
+} GCLargeObjectSpace;
+
+typedef struct {
+    uint8_t* ip;
+    uint16_t id;
+    uint32_t allocated;
+    uint32_t sampled;
+    uint32_t survived;
+    bool isPretenured;
+} GCAllocationSite;
+
+typedef struct {
+    int count;
+    int slotCapacity;
+    GCAllocationSite* sites;
+    uint16_t* slots;
+} GCAllocationSiteMap;
+
+typedef struct {
+    uv_thread_t thread;
+    uv_mutex_t mutex;
+    uv_cond_t condition;
+    Obj* objects;
+    size_t largeBytesSwept;
+    size_t largeBytesFreed;
+    bool isRunning;
+    bool isTerminating;
+} GCSweeper;
+
 struct GC {
     GCGeneration* generations[4];
+    GCLargeObjectSpace largeObjects;
+    GCAllocationSiteMap allocationSites;
+    GCSweeper* sweeper;
+    uint64_t startTime;
+    uint64_t gcTime;
+    bool isCollecting;
+    bool isCompacting;
+    bool isCompactionPending;
     int grayCount;
     int grayCapacity;
     Obj** grayStack;
@@ -53,6 +104,8 @@ struct GC {
 
 #define GET_GC_GENERATION(generation) vm->gc->generations[generation]
 
+#define IS_LARGE_OBJECT(size) ((size) >= vm->gc->largeObjects.threshold)
+
 #define PROCESS_WRITE_BARRIER(source, target) \
     do { \
        if (sourceOlderThanTarget(source, target)) { \
@@ -68,11 +121,13 @@ void addToRememberedSet(VM* vm, Obj* object, GCGenerationType generation);
 void markObject(VM* vm, Obj* object, GCGenerationType generation);
 void markValue(VM* vm, Value value, GCGenerationType generation);
 void markRememberedSet(VM* vm, GCGenerationType generation);
+void trackAllocationSite(VM* vm, Obj* object, uint8_t* ip);
 void collectGarbage(VM* vm, GCGenerationType generation);
+void compactHeap(VM* vm);
 void freeObjects(VM* vm);
 
 static inline bool sourceOlderThanTarget(Obj* source, Value target) {
-    return IS_OBJ(target) && (source->generation > OBJ_GEN(target));
+    return IS_OBJ(target) && AS_OBJ(target) != NULL && (source->generation > OBJ_GEN(target));
 }
 
 #endif // !clox_memory_h
\ No newline at end of file
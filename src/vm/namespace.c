@@ -149,10 +149,7 @@ InterpretResult runModule(VM* vm, ObjModule* module, bool isRootModule) {
     }
     else {
         callClosure(vm, module->closure, 0);
-        if (!isRootModule) vm->apiStackDepth++;
-        InterpretResult result = run(vm);
-        if (!isRootModule) vm->apiStackDepth--;
-        return result;
+        return isRootModule ? run(vm) : runReentrant(vm, vm->frameCount - 1);
     }
 }
 
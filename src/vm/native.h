@@ -10,10 +10,18 @@
 
 #define LOX_FUNCTION(name) static Value name##NativeFunction(VM* vm, int argCount, Value* args)
 #define LOX_METHOD(className, name) static Value name##NativeMethodFor##className(VM* vm, Value receiver, int argCount, Value* args)
+#define LOX_CONTINUATION(className, name) static Value name##ContinuationFor##className(VM* vm, Value* slots, Value result)
+#define CALL_CONTINUATION(className, name, argCount, ...) \
+    callContinuation(vm, slots, slots[1], name##ContinuationFor##className, argCount, __VA_ARGS__)
 #define DEF_FUNCTION(name, arity, ...) defineNativeFunction(vm, #name, arity, false, name##NativeFunction, __VA_ARGS__)
 #define DEF_FUNCTION_ASYNC(name, arity, ...) defineNativeFunction(vm, #name, arity, true, name##NativeFunction, __VA_ARGS__)
 #define DEF_METHOD(klass, className, name, arity, ...) defineNativeMethod(vm, klass, #name, arity, false, name##NativeMethodFor##className, __VA_ARGS__)
 #define DEF_METHOD_ASYNC(klass, className, name, arity, ...) defineNativeMethod(vm, klass, #name, arity, true, name##NativeMethodFor##className, __VA_ARGS__)
+#define DEF_METHOD_BORROWING(klass, className, name, arity, ...) \
+  do { \
+       defineNativeMethod(vm, klass, #name, arity, false, name##NativeMethodFor##className, __VA_ARGS__); \
+       getNativeMethod(vm, klass, #name)->isBorrowing = true; \
+  } while(false)
 #define DEF_OPERATOR(klass, className, symbol, name, arity, ...) defineNativeMethod(vm, klass, #symbol, arity, false, name##NativeMethodFor##className, __VA_ARGS__)
 #define DEF_INTERCEPTOR(klass, className, type, name, arity, ...) \
   do { \
@@ -22,6 +30,7 @@
   } while(false) 
 
 #define RETURN_VAL(value) return (value)
+#define RETURN_CONTINUATION(className, name) return startContinuation(vm, args - 1, argCount, name##ContinuationFor##className)
 #define RETURN_NIL return NIL_VAL
 #define RETURN_FALSE return BOOL_VAL(false)
 #define RETURN_TRUE return BOOL_VAL(true)
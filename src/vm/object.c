@@ -11,6 +11,7 @@ Obj* allocateObject(VM* vm, size_t size, ObjType type, ObjClass* klass, GCGenera
     object->type = type;
     object->klass = klass;
     object->isMarked = false;
+    object->siteID = 0;
     object->generation = generation;
     object->objectID = 0;
     object->shapeID = getDefaultShapeIDForObject(object);
@@ -68,6 +69,7 @@ void initClosure(VM* vm, ObjClosure* closure, ObjFunction* function) {
     closure->module = vm->currentModule;
     closure->upvalues = upvalues;
     closure->upvalueCount = function->upvalueCount;
+    closure->borrowedCount = 0;
     pop(vm);
 }
 
@@ -77,6 +79,19 @@ ObjClosure* newClosure(VM* vm, ObjFunction* function) {
     return closure;
 }
 
+ObjClosure* newBorrowedClosure(VM* vm, ObjFunction* function) {
+    ObjClosure* closure = ALLOCATE_BORROWED_CLOSURE(vm->functionClass, function->upvalueCount);
+    closure->function = function;
+    closure->module = vm->currentModule;
+    closure->upvalues = (ObjUpvalue**)(closure->borrowedUpvalues + function->upvalueCount);
+    for (int i = 0; i < function->upvalueCount; i++) {
+        closure->upvalues[i] = NULL;
+    }
+    closure->upvalueCount = function->upvalueCount;
+    closure->borrowedCount = function->upvalueCount;
+    return closure;
+}
+
 ObjDictionary* newDictionary(VM* vm) {
     ObjDictionary* dict = ALLOCATE_OBJ(ObjDictionary, OBJ_DICTIONARY, vm->dictionaryClass);
     dict->count = 0;
@@ -116,18 +131,21 @@ ObjFile* newFile(VM* vm, ObjString* name) {
 }
 
 ObjFrame* newFrame(VM* vm, CallFrame* callFrame) {
-    ObjFrame* frame = ALLOCATE_OBJ(ObjFrame, OBJ_FRAME, NULL);
+    ObjFunction* function = callFrame->closure->function;
+    int slotCount = function->arity + 1;
+    int inlineCapacity = (function->maxLocals > slotCount) ? function->maxLocals : slotCount;
+    ObjFrame* frame = ALLOCATE_FRAME(inlineCapacity);
     frame->closure = callFrame->closure;
     frame->ip = callFrame->ip;
-    frame->slotCount = callFrame->closure->function->arity + 1; 
-    frame->handlerCount = callFrame->handlerCount;
+    frame->slots = frame->inlineSlots;
+    frame->slotCount = slotCount;
+    frame->slotCapacity = inlineCapacity;
+    frame->inlineCapacity = inlineCapacity;
+    frame->handlerCount = 0;
+    frame->handlerStack = NULL;
 
     for (int i = 0; i < frame->slotCount; i++) {
-        frame->slots[i] = peek(vm, callFrame->closure->function->arity - i);
-    }
-
-    for (int i = 0; i < frame->handlerCount; i++) {
-        frame->handlerStack[i] = callFrame->handlerStack[i];
+        frame->slots[i] = peek(vm, function->arity - i);
     }
     return frame;
 }
@@ -139,9 +157,12 @@ ObjFunction* newFunction(VM* vm, ObjString* name, bool isAsync) {
 
     function->arity = 0;
     function->upvalueCount = 0;
+    function->maxLocals = 0;
     function->isGenerator = false;
     function->isAsync = isAsync;
+    function->interceptor = INTERCEPTOR_NONE;
     function->name = name;
+    function->closure = NULL;
     initChunk(&function->chunk, function->obj.generation);
     return function;
 }
@@ -157,8 +178,16 @@ ObjGenerator* newGenerator(VM* vm, ObjFrame* frame, ObjGenerator* outer) {
 }
 
 ObjInstance* newInstance(VM* vm, ObjClass* klass) {
-    ObjInstance* instance = ALLOCATE_OBJ(ObjInstance, OBJ_INSTANCE, klass);
+    int inlineCapacity = (klass != NULL && klass->instanceFieldCount > 0) ? klass->instanceFieldCount : 0;
+    if (inlineCapacity > INSTANCE_MAX_INLINE_FIELDS) inlineCapacity = INSTANCE_MAX_INLINE_FIELDS;
+    ObjInstance* instance = ALLOCATE_INSTANCE(klass, inlineCapacity);
     initValueArray(&instance->fields, instance->obj.generation);
+    instance->indexes = NULL;
+    instance->inlineCapacity = inlineCapacity;
+    if (inlineCapacity > 0) {
+        instance->fields.values = instance->inlineFields;
+        instance->fields.capacity = inlineCapacity;
+    }
     return instance;
 }
 
@@ -188,7 +217,7 @@ ObjModule* newModule(VM* vm, ObjString* path) {
         }
     }
     
-    tableSet(vm, &vm->modules, path, NIL_VAL);
+    tableSet(vm, &vm->modules, path, OBJ_VAL(module));
     return module;
 }
 
@@ -230,6 +259,7 @@ ObjNativeMethod* newNativeMethod(VM* vm, ObjClass* klass, ObjString* name, int a
     nativeMethod->name = name;
     nativeMethod->arity = arity;
     nativeMethod->isAsync = isAsync;
+    nativeMethod->isBorrowing = false;
     nativeMethod->method = method;
     return nativeMethod;
 }
@@ -317,9 +347,9 @@ ObjValueInstance* newValueInstance(VM* vm, Value value, ObjClass* klass) {
 }
 
 Value getObjProperty(VM* vm, ObjInstance* object, char* name) {
-    IDMap* idMap = getShapeIndexes(vm, object->obj.shapeID);
+    ShapeProperty* property = getShapeProperty(vm, name);
     int index;
-    idMapGet(idMap, newStringPerma(vm, name), &index);
+    if (!getShapePropertyIndex(vm, property, &object->obj, &index)) return NIL_VAL;
     return object->fields.values[index];
 }
 
@@ -333,17 +363,11 @@ Value getObjPropertyByIndex(VM* vm, ObjInstance* object, int index) {
 
 void setObjProperty(VM* vm, ObjInstance* object, char* name, Value value) {
     PROCESS_WRITE_BARRIER((Obj*)object, value);
-    IDMap* idMap = getShapeIndexes(vm, object->obj.shapeID);
-    ObjString* key = newStringPerma(vm, name);
+    ShapeProperty* property = getShapeProperty(vm, name);
     int index;
-    push(vm, OBJ_VAL(key));
 
-    if (idMapGet(idMap, key, &index)) object->fields.values[index] = value;
-    else {
-        transitionShapeForObject(vm, &object->obj, key);
-        valueArrayWrite(vm, &object->fields, value);
-    }
-    pop(vm);
+    if (getShapePropertyIndex(vm, property, &object->obj, &index)) object->fields.values[index] = value;
+    else addObjProperty(vm, object, property->key, value);
 }
 
 void setObjPropertyByIndex(VM* vm, ObjInstance* object, int index, Value value) {
@@ -355,23 +379,80 @@ void setObjPropertyByIndex(VM* vm, ObjInstance* object, int index, Value value)
     object->fields.values[index] = value;
 }
 
+void appendObjProperty(VM* vm, ObjInstance* object, Value value) {
+    ValueArray* fields = &object->fields;
+    if (fields->count == object->inlineCapacity && hasInlineFields(object)) {
+        int capacity = GROW_CAPACITY(fields->capacity);
+        Value* values = ALLOCATE(Value, capacity, fields->generation);
+        memcpy(values, object->inlineFields, sizeof(Value) * fields->count);
+        fields->values = values;
+        fields->capacity = capacity;
+    }
+    valueArrayWrite(vm, fields, value);
+
+    ObjClass* klass = object->obj.klass;
+    if (klass != NULL && fields->count > klass->instanceFieldCount) klass->instanceFieldCount = fields->count;
+}
+
+static bool shouldTransitionToDictionary(VM* vm, ObjInstance* object, ObjString* name) {
+    Shape* shape = getShapeFromID(vm, object->obj.shapeID);
+    if (shape->nextIndex >= SHAPE_MAX_PROPERTIES) return true;
+
+    int index;
+    if (idMapGet(&shape->edges, name, &index)) return false;
+    ObjClass* klass = object->obj.klass;
+    return vm->shapes.count >= SHAPE_MAX_COUNT || (klass != NULL && klass->shapeCount >= SHAPE_MAX_TRANSITIONS);
+}
+
+static void transitionToDictionary(VM* vm, ObjInstance* object, IDMap* from) {
+    IDMap* indexes = ALLOCATE(IDMap, 1, object->obj.generation);
+    initIDMap(indexes, object->obj.generation);
+    object->indexes = indexes;
+    idMapAddAll(vm, from, indexes);
+    object->obj.shapeID = vm->shapes.dictionaryShapeID;
+
+    for (int i = 0; i < indexes->capacity; i++) {
+        IDEntry* entry = &indexes->entries[i];
+        if (entry->key != NULL) PROCESS_WRITE_BARRIER((Obj*)object, OBJ_VAL(entry->key));
+    }
+}
+
+void addObjProperty(VM* vm, ObjInstance* object, ObjString* name, Value value) {
+    if (object->indexes == NULL && shouldTransitionToDictionary(vm, object, name)) {
+        transitionToDictionary(vm, object, getShapeIndexes(vm, object->obj.shapeID));
+    }
+
+    if (object->indexes != NULL) {
+        PROCESS_WRITE_BARRIER((Obj*)object, OBJ_VAL(name));
+        idMapSet(vm, object->indexes, name, object->fields.count);
+    }
+    else {
+        int shapeCount = vm->shapes.count;
+        transitionShapeForObject(vm, &object->obj, name);
+        if (vm->shapes.count > shapeCount && object->obj.klass != NULL) object->obj.klass->shapeCount++;
+    }
+    appendObjProperty(vm, object, value);
+}
+
 void copyObjProperty(VM* vm, ObjInstance* fromObject, ObjInstance* toObject, char* name) {
     Value value = getObjProperty(vm, fromObject, name);
     setObjProperty(vm, toObject, name, value);
 }
 
 void copyObjProperties(VM* vm, ObjInstance* fromObject, ObjInstance* toObject) {
-    toObject->obj.shapeID = fromObject->obj.shapeID;
+    if (fromObject->indexes != NULL) transitionToDictionary(vm, toObject, fromObject->indexes);
+    else toObject->obj.shapeID = fromObject->obj.shapeID;
+
     for (int i = 0; i < fromObject->fields.count; i++) {
         PROCESS_WRITE_BARRIER((Obj*)toObject, fromObject->fields.values[i]);
-        valueArrayWrite(vm, &toObject->fields, fromObject->fields.values[i]);
+        appendObjProperty(vm, toObject, fromObject->fields.values[i]);
     }
 }
 
 Value getObjMethod(VM* vm, Value object, char* name) {
     ObjClass* klass = getObjClass(vm, object);
     Value method;
-    if (!tableGet(&klass->methods, newStringPerma(vm, name), &method)) {
+    if (!tableGet(&klass->methods, getShapeProperty(vm, name)->key, &method)) {
         runtimeError(vm, "Method %s::%s does not exist.", klass->name->chars, name);
         exit(70);
     }
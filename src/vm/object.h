@@ -13,10 +13,17 @@
 #include "value.h"
 #include "../compiler/chunk.h"
 
+#define CLASS_DISPLAY_SIZE 8
+#define INSTANCE_MAX_INLINE_FIELDS 32
+
 #define ALLOCATE_OBJ(type, objectType, objectClass) (type*)allocateObject(vm, sizeof(type), objectType, objectClass, GC_GENERATION_TYPE_EDEN)
 #define ALLOCATE_OBJ_GEN(type, objectType, objectClass, generation) (type*)allocateObject(vm, sizeof(type), objectType, objectClass, generation)
 #define ALLOCATE_CLASS(classClass) ALLOCATE_OBJ_GEN(ObjClass, OBJ_CLASS, classClass, GC_GENERATION_TYPE_PERMANENT)
 #define ALLOCATE_CLOSURE(closureClass, generation) ALLOCATE_OBJ_GEN(ObjClosure, OBJ_CLOSURE, closureClass, generation)
+#define ALLOCATE_BORROWED_CLOSURE(closureClass, upvalueCount) \
+    (ObjClosure*)allocateObject(vm, sizeOfBorrowedClosure(upvalueCount), OBJ_CLOSURE, closureClass, GC_GENERATION_TYPE_EDEN)
+#define ALLOCATE_FRAME(inlineCapacity) (ObjFrame*)allocateObject(vm, sizeof(ObjFrame) + sizeof(Value) * (inlineCapacity), OBJ_FRAME, NULL, GC_GENERATION_TYPE_EDEN)
+#define ALLOCATE_INSTANCE(instanceClass, inlineCapacity) (ObjInstance*)allocateObject(vm, sizeof(ObjInstance) + sizeof(Value) * (inlineCapacity), OBJ_INSTANCE, instanceClass, GC_GENERATION_TYPE_EDEN)
 #define ALLOCATE_NAMESPACE(namespaceClass) ALLOCATE_OBJ_GEN(ObjNamespace, OBJ_NAMESPACE, namespaceClass, GC_GENERATION_TYPE_PERMANENT)
 
 #define OBJ_TYPE(value)             (AS_OBJ(value)->type)
@@ -117,12 +124,19 @@ typedef enum {
     OBJ_VOID
 } ObjType;
 
+typedef enum {
+    STRING_ENCODING_UNKNOWN,
+    STRING_ENCODING_ASCII,
+    STRING_ENCODING_UTF8
+} StringEncoding;
+
 struct Obj {
     uint64_t objectID;
     int shapeID;
     ObjType type;
     ObjClass* klass;
     bool isMarked;
+    uint16_t siteID;
     GCGenerationType generation;
     struct Obj* next;
 };
@@ -130,6 +144,9 @@ struct Obj {
 struct ObjInstance {
     Obj obj;
     ValueArray fields;
+    IDMap* indexes;
+    int inlineCapacity;
+    Value inlineFields[];
 };
 
 typedef struct {
@@ -142,10 +159,13 @@ typedef struct {
     Obj obj;
     int arity;
     int upvalueCount;
+    int maxLocals;
     bool isGenerator;
     bool isAsync;
+    InterceptorType interceptor;
     Chunk chunk;
     ObjString* name;
+    ObjClosure* closure;
 } ObjFunction;
 
 typedef Value (*NativeFunction)(VM* vm, int argCount, Value* args);
@@ -168,6 +188,7 @@ typedef struct {
     ObjString* name;
     int arity;
     bool isAsync;
+    bool isBorrowing;
     NativeMethod method;
 } ObjNativeMethod;
  
@@ -240,10 +261,13 @@ typedef struct {
     Obj obj;
     ObjClosure* closure;
     uint8_t* ip;
-    Value slots[UINT8_MAX];
-    uint8_t slotCount;
-    uint8_t handlerCount;
-    ExceptionHandler handlerStack[UINT4_MAX];
+    Value* slots;
+    int slotCount;
+    int slotCapacity;
+    int inlineCapacity;
+    int handlerCount;
+    ExceptionHandler* handlerStack;
+    Value inlineSlots[];
 } ObjFrame;
 
 struct ObjGenerator {
@@ -271,12 +295,19 @@ struct ObjClass {
     ObjString* fullName;
     struct ObjNamespace* namespace;
     struct ObjClass* superclass;
+    struct ObjClass* display[CLASS_DISPLAY_SIZE];
+    int depth;
     ValueArray traits;
+    uint64_t* traitSet;
+    int traitSetCount;
     bool isNative;
     uint16_t interceptors;
     IDMap indexes;
     ValueArray fields;
     Table methods;
+    Value initializer;
+    int instanceFieldCount;
+    int shapeCount;
 };
 
 struct ObjClosure {
@@ -285,6 +316,8 @@ struct ObjClosure {
     ObjModule* module;
     ObjUpvalue** upvalues;
     int upvalueCount;
+    int borrowedCount;
+    ObjUpvalue borrowedUpvalues[];
 };
 
 struct ObjException {
@@ -337,6 +370,8 @@ struct ObjString {
     Obj obj;
     int length;
     uint32_t hash;
+    bool isInterned;
+    uint8_t encoding;
     char chars[];
 };
 
@@ -346,6 +381,7 @@ ObjBoundMethod* newBoundMethod(VM* vm, Value receiver, Value method);
 ObjClass* newClass(VM* vm, ObjString* name, ObjType classType);
 void initClosure(VM* vm, ObjClosure* closure, ObjFunction* function);
 ObjClosure* newClosure(VM* vm, ObjFunction* function);
+ObjClosure* newBorrowedClosure(VM* vm, ObjFunction* function);
 ObjDictionary* newDictionary(VM* vm);
 ObjEntry* newEntry(VM* vm, Value key, Value value);
 ObjException* newException(VM* vm, ObjString* message, ObjClass* klass);
@@ -372,6 +408,8 @@ Value getObjProperty(VM* vm, ObjInstance* object, char* name);
 Value getObjPropertyByIndex(VM* vm, ObjInstance* object, int index);
 void setObjProperty(VM* vm, ObjInstance* object, char* name, Value value);
 void setObjPropertyByIndex(VM* vm, ObjInstance* object, int index, Value value);
+void appendObjProperty(VM* vm, ObjInstance* object, Value value);
+void addObjProperty(VM* vm, ObjInstance* object, ObjString* name, Value value);
 void copyObjProperty(VM* vm, ObjInstance* object, ObjInstance* object2, char* name);
 void copyObjProperties(VM* vm, ObjInstance* fromObject, ObjInstance* toObject);
 Value getObjMethod(VM* vm, Value object, char* name);
@@ -381,4 +419,20 @@ static inline bool isObjType(Value value, ObjType type) {
     return IS_OBJ(value) && (AS_OBJ(value)->type == type);
 }
 
+static inline size_t sizeOfBorrowedClosure(int upvalueCount) {
+    return sizeof(ObjClosure) + (sizeof(ObjUpvalue) + sizeof(ObjUpvalue*)) * upvalueCount;
+}
+
+static inline bool isBorrowedUpvalue(ObjClosure* closure, ObjUpvalue* upvalue) {
+    return upvalue >= closure->borrowedUpvalues && upvalue < closure->borrowedUpvalues + closure->borrowedCount;
+}
+
+static inline bool hasInlineFields(ObjInstance* instance) {
+    return instance->inlineCapacity > 0 && instance->fields.values == instance->inlineFields;
+}
+
+static inline bool hasInlineSlots(ObjFrame* frame) {
+    return frame->slots == frame->inlineSlots;
+}
+
 #endif // !clox_object_h
\ No newline at end of file
@@ -109,8 +109,7 @@ void promiseReject(VM* vm, ObjPromise* promise, Value exception) {
 
 void promiseThen(VM* vm, ObjPromise* promise, Value value) {
     for (int i = 0; i < promise->handlers.count; i++) {
-        ObjBoundMethod* handler = newBoundMethod(vm, OBJ_VAL(promise), promise->handlers.values[i]);
-        callReentrantMethod(vm, OBJ_VAL(promise), handler->method, value);
+        callReentrantMethod(vm, OBJ_VAL(promise), promise->handlers.values[i], value);
     }
     initValueArray(&promise->handlers, promise->obj.generation);
 }
@@ -1,6 +1,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "hash.h"
 #include "memory.h"
 #include "shape.h"
 
@@ -19,6 +20,19 @@ static void initRootShape(Shape* shape) {
 #endif
 }
 
+static void createDictionaryShape(VM* vm) {
+    Shape dictionaryShape = {
+        .id = vm->shapes.count,
+        .parentID = -1,
+        .type = SHAPE_DICTIONARY,
+        .nextIndex = 0
+    };
+    initIDMap(&dictionaryShape.edges, GC_GENERATION_TYPE_PERMANENT);
+    initIDMap(&dictionaryShape.indexes, GC_GENERATION_TYPE_PERMANENT);
+    appendToShapeTree(vm, &dictionaryShape);
+    vm->shapes.dictionaryShapeID = dictionaryShape.id;
+}
+
 static void createDefaultShapes(VM* vm) {
     int shapeIDLength = createShapeFromParent(vm, 0, newStringPerma(vm, "length"));
     defaultShapeIDs[OBJ_ARRAY] = shapeIDLength;
@@ -87,13 +101,14 @@ static void createDefaultShapes(VM* vm) {
 }
 
 void initShapeTree(VM* vm) {
-    ShapeTree shapeTree = { .list = NULL, .count = 0, .capacity = 0, .rootShape = NULL };
+    ShapeTree shapeTree = { .list = NULL, .count = 0, .capacity = 0, .rootShape = NULL, .dictionaryShapeID = -1 };
     vm->shapes = shapeTree;
 
     Shape rootShape;
     initRootShape(&rootShape);
     appendToShapeTree(vm, &rootShape);
     createDefaultShapes(vm);
+    createDictionaryShape(vm);
 }
 
 void freeShapeTree(VM* vm, ShapeTree* shapeTree) {
@@ -124,6 +139,11 @@ IDMap* getShapeIndexes(VM* vm, int id) {
     return &vm->shapes.list[id].indexes;
 }
 
+IDMap* getObjectIndexes(VM* vm, Obj* object) {
+    if (object->shapeID == vm->shapes.dictionaryShapeID) return ((ObjInstance*)object)->indexes;
+    return &vm->shapes.list[object->shapeID].indexes;
+}
+
 int getDefaultShapeIDForObject(Obj* object) {
     return defaultShapeIDs[object->type];
 }
@@ -188,8 +208,41 @@ int getShapeFromParent(VM* vm, int parentID, ObjString* edge) {
 }
 
 int getIndexFromObjectShape(VM* vm, Obj* object, ObjString* edge) {
-    IDMap* idMap = &vm->shapes.list[object->shapeID].indexes;
+    IDMap* idMap = getObjectIndexes(vm, object);
     int index;
     if (idMapGet(idMap, edge, &index)) return index;
     return -1;
+}
+
+ShapeProperty* getShapeProperty(VM* vm, const char* name) {
+    uint32_t slot = hash64To32Bits((uint64_t)(uintptr_t)name) & (SHAPE_PROPERTY_CACHE_SIZE - 1);
+    ShapeProperty* property = &vm->shapes.properties[slot];
+    if (property->name != name) {
+        property->name = name;
+        property->key = newStringPerma(vm, name);
+        property->shapeID = -1;
+        property->index = -1;
+    }
+    return property;
+}
+
+void markShapeProperties(VM* vm, GCGenerationType generation) {
+    for (int i = 0; i < SHAPE_PROPERTY_CACHE_SIZE; i++) {
+        ShapeProperty* property = &vm->shapes.properties[i];
+        if (property->key != NULL) markObject(vm, (Obj*)property->key, generation);
+    }
+}
+
+bool getShapePropertyIndex(VM* vm, ShapeProperty* property, Obj* object, int* index) {
+    if (property->shapeID == object->shapeID) {
+        *index = property->index;
+        return true;
+    }
+
+    if (!idMapGet(getObjectIndexes(vm, object), property->key, index)) return false;
+    if (object->shapeID != vm->shapes.dictionaryShapeID) {
+        property->shapeID = object->shapeID;
+        property->index = *index;
+    }
+    return true;
 }
\ No newline at end of file
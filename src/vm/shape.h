@@ -5,10 +5,16 @@
 #include "id.h"
 #include "object.h"
 
+#define SHAPE_MAX_COUNT 65536
+#define SHAPE_MAX_PROPERTIES 64
+#define SHAPE_MAX_TRANSITIONS 256
+#define SHAPE_PROPERTY_CACHE_SIZE 256
+
 typedef enum {
     SHAPE_ROOT,
     SHAPE_NORMAL,
     SHAPE_COMPLEX,
+    SHAPE_DICTIONARY,
     SHAPE_INVALID
 } ShapeType;
 
@@ -21,11 +27,20 @@ typedef struct {
     int nextIndex;
 } Shape;
 
+typedef struct {
+    const char* name;
+    ObjString* key;
+    int shapeID;
+    int index;
+} ShapeProperty;
+
 typedef struct {
     Shape* list;
     int count;
     int capacity;
     Shape* rootShape;
+    int dictionaryShapeID;
+    ShapeProperty properties[SHAPE_PROPERTY_CACHE_SIZE];
 } ShapeTree;
 
 void initShapeTree(VM* vm);
@@ -33,9 +48,13 @@ void freeShapeTree(VM* vm, ShapeTree* shapeTree);
 void appendToShapeTree(VM* vm, Shape* shape);
 Shape* getShapeFromID(VM* vm, int id);
 IDMap* getShapeIndexes(VM* vm, int id);
+IDMap* getObjectIndexes(VM* vm, Obj* object);
 int getDefaultShapeIDForObject(Obj* object);
 int createShapeFromParent(VM* vm, int parentID, ObjString* edge);
 int transitionShapeForObject(VM* vm, Obj* object, ObjString* edge);
 int getIndexFromObjectShape(VM* vm, Obj* object, ObjString* edge);
+ShapeProperty* getShapeProperty(VM* vm, const char* name);
+bool getShapePropertyIndex(VM* vm, ShapeProperty* property, Obj* object, int* index);
+void markShapeProperties(VM* vm, GCGenerationType generation);
 
 #endif // !clox_shape_h
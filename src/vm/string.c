@@ -13,6 +13,8 @@ static ObjString* allocateString(VM* vm, char* chars, int length, uint32_t hash,
     ObjString* string = ALLOCATE_STRING_GEN(length, vm->stringClass, generation);
     string->length = length;
     string->hash = hash;
+    string->isInterned = true;
+    string->encoding = STRING_ENCODING_UNKNOWN;
 
     push(vm, OBJ_VAL(string));
     memcpy(string->chars, chars, length);
@@ -28,10 +30,17 @@ ObjString* createString(VM* vm, char* chars, int length, uint32_t hash, ObjClass
     string->chars[length] = '\0';
     string->length = length;
     string->hash = hash;
+    string->isInterned = false;
+    string->encoding = STRING_ENCODING_UNKNOWN;
     return string;
 }
 
+static bool shouldIntern(VM* vm, int length) {
+    return vm->config.gcInternMaxLength == 0 || length <= vm->config.gcInternMaxLength;
+}
+
 ObjString* takeString(VM* vm, char* chars, int length) {
+    if (!shouldIntern(vm, length)) return takeStringTransient(vm, chars, length);
     uint32_t hash = hashString(chars, length);
     ObjString* interned = tableFindString(&vm->strings, chars, length, hash);
     if (interned != NULL) {
@@ -55,7 +64,15 @@ ObjString* takeStringPerma(VM* vm, char* chars, int length) {
     return string;
 }
 
+ObjString* takeStringTransient(VM* vm, char* chars, int length) {
+    if (vm->config.gcInternMaxLength == 0) return takeString(vm, chars, length);
+    ObjString* string = createString(vm, chars, length, 0, vm->stringClass);
+    FREE_ARRAY(char, chars, (size_t)length + 1, string->obj.generation);
+    return string;
+}
+
 ObjString* copyString(VM* vm, const char* chars, int length) {
+    if (!shouldIntern(vm, length)) return copyStringTransient(vm, chars, length);
     uint32_t hash = hashString(chars, length);
     ObjString* interned = tableFindString(&vm->strings, chars, length, hash);
     if (interned != NULL) return interned;
@@ -66,6 +83,11 @@ ObjString* copyString(VM* vm, const char* chars, int length) {
     return allocateString(vm, heapChars, length, hash, GC_GENERATION_TYPE_EDEN);
 }
 
+ObjString* copyStringTransient(VM* vm, const char* chars, int length) {
+    if (vm->config.gcInternMaxLength == 0) return copyString(vm, chars, length);
+    return createString(vm, (char*)chars, length, 0, vm->stringClass);
+}
+
 ObjString* copyStringPerma(VM* vm, const char* chars, int length) {
     uint32_t hash = hashString(chars, length);
     ObjString* interned = tableFindString(&vm->strings, chars, length, hash);
@@ -77,6 +99,36 @@ ObjString* copyStringPerma(VM* vm, const char* chars, int length) {
     return allocateString(vm, heapChars, length, hash, GC_GENERATION_TYPE_PERMANENT);
 }
 
+ObjString* internString(VM* vm, ObjString* string) {
+    if (string->isInterned) return string;
+    ObjString* interned = tableFindString(&vm->strings, string->chars, string->length, hashObjString(string));
+    if (interned != NULL) return interned;
+
+    string->isInterned = true;
+    push(vm, OBJ_VAL(string));
+    tableSet(vm, &vm->strings, string, NIL_VAL);
+    pop(vm);
+    return string;
+}
+
+bool isAsciiObjString(ObjString* string) {
+    if (string->encoding == STRING_ENCODING_UNKNOWN) {
+        string->encoding = utf8IsAscii(string->chars, string->length) ? STRING_ENCODING_ASCII : STRING_ENCODING_UTF8;
+    }
+    return string->encoding == STRING_ENCODING_ASCII;
+}
+
+bool stringsEqual(ObjString* string, ObjString* string2) {
+    if (string == string2) return true;
+    if (string->isInterned && string2->isInterned) return false;
+    return string->length == string2->length && hashObjString(string) == hashObjString(string2)
+        && memcmp(string->chars, string2->chars, string->length) == 0;
+}
+
+bool valuesIdentical(Value a, Value b) {
+    return a == b || (IS_STRING(a) && IS_STRING(b) && stringsEqual(AS_STRING(a), AS_STRING(b)));
+}
+
 ObjString* newString(VM* vm, const char* chars) {
     return copyString(vm, chars, (int)strlen(chars));
 }
@@ -85,6 +137,17 @@ ObjString* newStringPerma(VM* vm, const char* chars) {
     return copyStringPerma(vm, chars, (int)strlen(chars));
 }
 
+void initCharStrings(VM* vm) {
+    for (int i = 0; i <= UINT8_MAX; i++) {
+        char chars[2] = { (char)i, '\0' };
+        vm->charStrings[i] = copyStringPerma(vm, chars, 1);
+    }
+}
+
+ObjString* charString(VM* vm, char c) {
+    return vm->charStrings[(uint8_t)c];
+}
+
 ObjString* emptyString(VM* vm) {
     return copyStringPerma(vm, "", 0);
 }
@@ -131,7 +194,7 @@ ObjString* capitalizeString(VM* vm, ObjString* string) {
         heapChars[offset] = string->chars[offset];
     }
     heapChars[string->length] = '\0';
-    return takeString(vm, heapChars, (int)string->length);
+    return takeStringTransient(vm, heapChars, (int)string->length);
 }
 
 ObjString* concatenateString(VM* vm, ObjString* string, ObjString* string2, const char* separator) {
@@ -173,7 +236,7 @@ ObjString* decapitalizeString(VM* vm, ObjString* string) {
         heapChars[offset] = string->chars[offset];
     }
     heapChars[string->length] = '\0';
-    return takeString(vm, heapChars, (int)string->length);
+    return takeStringTransient(vm, heapChars, (int)string->length);
 }
 
 ObjString* replaceString(VM* vm, ObjString* original, ObjString* target, ObjString* replace) {
@@ -186,28 +249,29 @@ ObjString* replaceString(VM* vm, ObjString* original, ObjString* target, ObjStri
     char* heapChars = ALLOCATE(char, (size_t)newLength + 1, GC_GENERATION_TYPE_EDEN);
     pop(vm);
 
-    int offset = 0;
-    while (offset < startIndex) {
-        heapChars[offset] = original->chars[offset];
-        offset++;
-    }
-
-    while (offset < startIndex + replace->length) {
-        heapChars[offset] = replace->chars[offset - startIndex];
-        offset++;
-    }
+    memcpy(heapChars, original->chars, startIndex);
+    memcpy(heapChars + startIndex, replace->chars, replace->length);
+    memcpy(heapChars + startIndex + replace->length, original->chars + startIndex + target->length, original->length - startIndex - target->length);
+    heapChars[newLength] = '\0';
+    return takeStringTransient(vm, heapChars, (int)newLength);
+}
 
-    while (offset < newLength) {
-        heapChars[offset] = original->chars[offset - replace->length + target->length];
-        offset++;
+static ObjString* inheritEncoding(ObjString* string, ObjString* source) {
+    if (string->encoding == STRING_ENCODING_UNKNOWN && source->encoding == STRING_ENCODING_ASCII) {
+        string->encoding = STRING_ENCODING_ASCII;
     }
-
-    heapChars[newLength] = '\0';
-    return takeString(vm, heapChars, (int)newLength);
+    return string;
 }
 
 ObjString* reverseString(VM* vm, ObjString* original) {
     char* heapChars = ALLOCATE(char, (size_t)original->length + 1, GC_GENERATION_TYPE_EDEN);
+    if (isAsciiObjString(original)) {
+        for (int i = 0; i < original->length; i++) {
+            heapChars[original->length - i - 1] = original->chars[i];
+        }
+        return inheritEncoding(takeStringTransient(vm, heapChars, original->length), original);
+    }
+
     int i = 0;
     while (i < original->length) {
         int offset = utf8CodePointOffset(vm, original->chars, i);
@@ -216,16 +280,31 @@ ObjString* reverseString(VM* vm, ObjString* original) {
         }
         i += offset;
     }
-    return takeString(vm, heapChars, original->length);
+    return takeStringTransient(vm, heapChars, original->length);
 }
 
-int searchString(VM* vm, ObjString* haystack, ObjString* needle, uint32_t start) {
-    if (needle->length == 0) return start;
-    if (start + needle->length > (uint32_t)haystack->length || start >= (uint32_t)haystack->length) return -1;
-    uint32_t shift[UINT8_MAX];
+static int searchStringShort(ObjString* haystack, ObjString* needle, uint32_t start) {
+    const char* chars = haystack->chars;
+    const char* last = chars + haystack->length - needle->length;
+    const char* cursor = chars + start;
     uint32_t needleEnd = needle->length - 1;
 
-    for (uint32_t index = 0; index < UINT8_MAX; index++) {
+    while (cursor <= last) {
+        cursor = memchr(cursor, needle->chars[0], (size_t)(last - cursor) + 1);
+        if (cursor == NULL) return -1;
+        if (cursor[needleEnd] == needle->chars[needleEnd] && memcmp(cursor + 1, needle->chars + 1, needleEnd) == 0) {
+            return (int)(cursor - chars);
+        }
+        cursor++;
+    }
+    return -1;
+}
+
+static int searchStringLong(ObjString* haystack, ObjString* needle, uint32_t start) {
+    uint32_t shift[UINT8_MAX + 1];
+    uint32_t needleEnd = needle->length - 1;
+
+    for (uint32_t index = 0; index <= UINT8_MAX; index++) {
         shift[index] = needle->length;
     }
 
@@ -248,6 +327,16 @@ int searchString(VM* vm, ObjString* haystack, ObjString* needle, uint32_t start)
     return -1;
 }
 
+int searchString(VM* vm, ObjString* haystack, ObjString* needle, uint32_t start) {
+    if (needle->length == 0) return start;
+    if (start + needle->length > (uint32_t)haystack->length || start >= (uint32_t)haystack->length) return -1;
+    if (needle->length == 1) {
+        const char* match = memchr(haystack->chars + start, needle->chars[0], (size_t)haystack->length - start);
+        return (match == NULL) ? -1 : (int)(match - haystack->chars);
+    }
+    return (needle->length < STRING_SEARCH_LONG_NEEDLE) ? searchStringShort(haystack, needle, start) : searchStringLong(haystack, needle, start);
+}
+
 ObjString* subString(VM* vm, ObjString* original, int fromIndex, int toIndex) {
     if (fromIndex >= original->length || toIndex > original->length || fromIndex > toIndex) {
         return copyString(vm, "", 0);
@@ -260,23 +349,42 @@ ObjString* subString(VM* vm, ObjString* original, int fromIndex, int toIndex) {
     }
 
     heapChars[newLength] = '\0';
-    return takeString(vm, heapChars, (int)newLength);
+    return inheritEncoding(takeStringTransient(vm, heapChars, (int)newLength), original);
+}
+
+static void asciiConvertCase(char* dest, const char* source, int length, char from) {
+    for (int i = 0; i < length; i++) {
+        uint8_t c = (uint8_t)source[i];
+        dest[i] = (char)(c ^ (((uint8_t)(c - from) < 26) << 5));
+    }
 }
 
 ObjString* toLowerString(VM* vm, ObjString* string) {
     if (string->length == 0) return string;
     char* heapChars = ALLOCATE(char, (size_t)string->length + 1, GC_GENERATION_TYPE_EDEN);
+    if (isAsciiObjString(string)) {
+        asciiConvertCase(heapChars, string->chars, string->length, 'A');
+        heapChars[string->length] = '\0';
+        return inheritEncoding(takeStringTransient(vm, heapChars, (int)string->length), string);
+    }
+
     memcpy(heapChars, string->chars, (size_t)string->length + 1);
     utf8lwr(heapChars);
-    return takeString(vm, heapChars, (int)string->length);
+    return takeStringTransient(vm, heapChars, (int)string->length);
 }
 
 ObjString* toUpperString(VM* vm, ObjString* string) {
     if (string->length == 0) return string;
     char* heapChars = ALLOCATE(char, (size_t)string->length + 1, GC_GENERATION_TYPE_EDEN);
+    if (isAsciiObjString(string)) {
+        asciiConvertCase(heapChars, string->chars, string->length, 'a');
+        heapChars[string->length] = '\0';
+        return inheritEncoding(takeStringTransient(vm, heapChars, (int)string->length), string);
+    }
+
     memcpy(heapChars, string->chars, (size_t)string->length + 1);
     utf8upr(heapChars);
-    return takeString(vm, heapChars, (int)string->length);
+    return takeStringTransient(vm, heapChars, (int)string->length);
 }
 
 ObjString* trimString(VM* vm, ObjString* string) {
@@ -288,19 +396,18 @@ ObjString* trimString(VM* vm, ObjString* string) {
         ltLen++;
     }
 
-    for (int i = string->length - 1; i >= 0; i--) {
+    for (int i = string->length - 1; i >= ltLen; i--) {
         char c = string->chars[i];
         if (c != ' ' && c != '\t' && c != '\n') break;
         rtLen++;
     }
 
-    int newLength = string->length - ltLen - rtLen + 1;
+    if (ltLen == 0 && rtLen == 0) return string;
+    int newLength = string->length - ltLen - rtLen;
     char* heapChars = ALLOCATE(char, (size_t)newLength + 1, GC_GENERATION_TYPE_EDEN);
-    for (int i = 0; i < newLength; i++) {
-        heapChars[i] = string->chars[i + ltLen];
-    }
+    memcpy(heapChars, string->chars + ltLen, newLength);
     heapChars[newLength] = '\0';
-    return takeString(vm, heapChars, (int)newLength);
+    return inheritEncoding(takeStringTransient(vm, heapChars, (int)newLength), string);
 }
 
 int utf8NumBytes(int value) {
@@ -376,8 +483,7 @@ int utf8Decode(const uint8_t* bytes, uint32_t length) {
 }
 
 ObjString* utf8StringFromByte(VM* vm, uint8_t byte) {
-    char chars[2] = { byte, '\0' };
-    return copyString(vm, chars, 1);
+    return charString(vm, (char)byte);
 }
 
 ObjString* utf8StringFromCodePoint(VM* vm, int codePoint) {
@@ -387,6 +493,28 @@ ObjString* utf8StringFromCodePoint(VM* vm, int codePoint) {
     return takeString(vm, utfChars, length);
 }
 
+bool utf8IsAscii(const char* string, int length) {
+    uint64_t bits = 0;
+    int i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        memcpy(&word, string + i, sizeof(uint64_t));
+        bits |= word;
+    }
+    for (; i < length; i++) {
+        bits |= (uint8_t)string[i];
+    }
+    return (bits & 0x8080808080808080ULL) == 0;
+}
+
+int utf8CodePointCount(const char* string, int length) {
+    int count = 0;
+    for (int i = 0; i < length; i++) {
+        count += ((uint8_t)string[i] & 0xc0) != 0x80;
+    }
+    return count;
+}
+
 int utf8CodePointOffset(VM* vm, const char* string, int index) {
     int offset = 0;
     do {
@@ -399,7 +527,7 @@ ObjString* utf8CodePointAtIndex(VM* vm, const char* string, int index) {
     int length = utf8CodePointOffset(vm, string, index);
     switch (length) {
         case 1: 
-            return copyString(vm, (char[]) { string[index], '\0' }, 1);
+            return charString(vm, string[index]);
         case 2: 
             return copyString(vm, (char[]) { string[index], string[index + 1], '\0' }, 2);
         case 3: 
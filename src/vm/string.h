@@ -5,16 +5,26 @@
 #include "object.h"
 #include "../inc/utf8.h"
 
+#define STRING_SEARCH_LONG_NEEDLE 16
+
 #define ALLOCATE_STRING(length, stringClass) (ObjString*)allocateObject(vm, sizeof(ObjString) + length + 1, OBJ_STRING, stringClass, GC_GENERATION_TYPE_EDEN)
 #define ALLOCATE_STRING_GEN(length, stringClass, generation) (ObjString*)allocateObject(vm, sizeof(ObjString) + length + 1, OBJ_STRING, stringClass, generation)
 
 ObjString* createString(VM* vm, char* chars, int length, uint32_t hash, ObjClass* klass);
 ObjString* takeString(VM* vm, char* chars, int length);
 ObjString* takeStringPerma(VM* vm, char* chars, int length);
+ObjString* takeStringTransient(VM* vm, char* chars, int length);
 ObjString* copyString(VM* vm, const char* chars, int length);
 ObjString* copyStringPerma(VM* vm, const char* chars, int length);
+ObjString* copyStringTransient(VM* vm, const char* chars, int length);
+ObjString* internString(VM* vm, ObjString* string);
+bool isAsciiObjString(ObjString* string);
+bool stringsEqual(ObjString* string, ObjString* string2);
+bool valuesIdentical(Value a, Value b);
 ObjString* newString(VM* vm, const char* chars);
 ObjString* newStringPerma(VM* vm, const char* chars);
+void initCharStrings(VM* vm);
+ObjString* charString(VM* vm, char c);
 ObjString* emptyString(VM* vm);
 ObjString* formattedString(VM* vm, const char* format, ...);
 ObjString* formattedStringPerma(VM* vm, const char* format, ...);
@@ -35,6 +45,8 @@ char* utf8Encode(int value);
 int utf8Decode(const uint8_t* bytes, uint32_t length);
 ObjString* utf8StringFromByte(VM* vm, uint8_t byte);
 ObjString* utf8StringFromCodePoint(VM* vm, int codePoint);
+bool utf8IsAscii(const char* string, int length);
+int utf8CodePointCount(const char* string, int length);
 int utf8CodePointOffset(VM* vm, const char* string, int index);
 ObjString* utf8CodePointAtIndex(VM* vm, const char* string, int index);
 
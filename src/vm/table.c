@@ -1,8 +1,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "hash.h"
 #include "memory.h"
 #include "object.h"
+#include "string.h"
 #include "table.h"
 
 void initTable(Table* table, GCGenerationType generation) {
@@ -18,7 +20,7 @@ void freeTable(VM* vm, Table* table) {
 }
 
 static Entry* findEntry(Entry* entries, int capacity, ObjString* key) {
-    uint32_t index = key->hash & (capacity - 1);
+    uint32_t index = hashObjString(key) & (capacity - 1);
     Entry* tombstone = NULL;
 
     for (;;) {
@@ -31,7 +33,7 @@ static Entry* findEntry(Entry* entries, int capacity, ObjString* key) {
                 if (tombstone == NULL) tombstone = entry;
             }
         }
-        else if (entry->key == key) {
+        else if (entry->key == key || (!key->isInterned && stringsEqual(entry->key, key))) {
             return entry;
         }
 
@@ -73,6 +75,7 @@ static void adjustCapacity(VM* vm, Table* table, int capacity) {
 }
 
 bool tableSet(VM* vm, Table* table, ObjString* key, Value value) {
+    if (!key->isInterned) key = internString(vm, key);
     if (table->count + 1 > table->capacity * TABLE_MAX_LOAD) {
         int capacity = GROW_CAPACITY(table->capacity);
         adjustCapacity(vm, table, capacity);
@@ -107,6 +110,20 @@ void tableAddAll(VM* vm, Table* from, Table* to) {
     }
 }
 
+int tableLiveCount(Table* table) {
+    int count = 0;
+    for (int i = 0; i < table->capacity; i++) {
+        if (table->entries[i].key != NULL) count++;
+    }
+    return count;
+}
+
+void tableShrink(VM* vm, Table* table, int capacity) {
+    if (capacity >= table->capacity) return;
+    if (capacity == 0) freeTable(vm, table);
+    else adjustCapacity(vm, table, capacity);
+}
+
 ObjString* tableFindString(Table* table, const char* chars, int length, uint32_t hash) {
     if (table->count == 0) return NULL;
 
@@ -123,15 +140,6 @@ ObjString* tableFindString(Table* table, const char* chars, int length, uint32_t
     }
 }
 
-void tableRemoveWhite(Table* table) {
-    for (int i = 0; i < table->capacity; i++) {
-        Entry* entry = &table->entries[i];
-        if (entry->key != NULL && !entry->key->obj.isMarked && entry->key->obj.generation < GC_GENERATION_TYPE_PERMANENT) {
-            tableDelete(table, entry->key);
-        }
-    }
-}
-
 void markTable(VM* vm, Table* table, GCGenerationType generation) {
     for (int i = 0; i < table->capacity; i++) {
         Entry* entry = &table->entries[i];
@@ -25,8 +25,9 @@ bool tableGet(Table* table, ObjString* key, Value* value);
 bool tableSet(VM* vm, Table* table, ObjString* key, Value value);
 bool tableDelete(Table* table, ObjString* key);
 void tableAddAll(VM* vm, Table* from, Table* to);
+int tableLiveCount(Table* table);
+void tableShrink(VM* vm, Table* table, int capacity);
 ObjString* tableFindString(Table* table, const char* chars, int length, uint32_t hash);
-void tableRemoveWhite(Table* table);
 void markTable(VM* vm, Table* table, GCGenerationType generation);
 
 #endif // !clox_table_h
\ No newline at end of file
@@ -29,6 +29,12 @@ void valueArrayWrite(VM* vm, ValueArray* array, Value value) {
     array->count++;
 }
 
+void valueArrayShrink(VM* vm, ValueArray* array, int capacity) {
+    if (capacity >= array->capacity || capacity < array->count) return;
+    array->values = GROW_ARRAY(Value, array->values, array->capacity, capacity, array->generation);
+    array->capacity = capacity;
+}
+
 void valueArrayAddAll(VM* vm, ValueArray* from, ValueArray* to) {
     if (from->count == 0) return;
     for (int i = 0; i < from->count; i++) {
@@ -87,7 +93,7 @@ Value valueArrayDelete(VM* vm, ValueArray* array, int index) {
 bool valueArraysEqual(ValueArray* aArray, ValueArray* bArray) {
     if (aArray->count != bArray->count) return false;
     for (int i = 0; i < aArray->count; i++) {
-        if (aArray->values[i] != bArray->values[i]) return false;
+        if (!valuesIdentical(aArray->values[i], bArray->values[i])) return false;
     }
     return true;
 }
@@ -153,7 +159,8 @@ bool valuesEqual(Value a, Value b) {
     if (IS_NUMBER(a) && IS_NUMBER(b)) {
         return AS_NUMBER(a) == AS_NUMBER(b);
     }
-    return a == b;
+    if (a == b) return true;
+    return IS_STRING(a) && IS_STRING(b) && stringsEqual(AS_STRING(a), AS_STRING(b));
 #else
     if (a.type != b.type) return false;
     switch (a.type) {
@@ -165,7 +172,8 @@ bool valuesEqual(Value a, Value b) {
         case VAL_FLOAT:  
             return AS_NUMBER(a) == AS_NUMBER(b);
         case VAL_OBJ:    
-            return AS_OBJ(a) == AS_OBJ(b);
+            if (AS_OBJ(a) == AS_OBJ(b)) return true;
+            return IS_STRING(a) && IS_STRING(b) && stringsEqual(AS_STRING(a), AS_STRING(b));
         default:         
             return false;
     }
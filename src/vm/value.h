@@ -161,6 +161,7 @@ char* valueToString(VM* vm, Value value);
 void initValueArray(ValueArray* array, GCGenerationType generation);
 void freeValueArray(VM* vm, ValueArray* array);
 void valueArrayWrite(VM* vm, ValueArray* array, Value value);
+void valueArrayShrink(VM* vm, ValueArray* array, int capacity);
 void valueArrayAddAll(VM* vm, ValueArray* from, ValueArray* to);
 void valueArrayPut(VM* vm, ValueArray* array, int index, Value value);
 void valueArrayInsert(VM* vm, ValueArray* array, int index, Value value);
@@ -82,7 +82,7 @@ bool loadGlobal(VM* vm, Chunk* chunk, uint8_t byte, Value* value) {
 
 bool hasInstanceVariable(VM* vm, Obj* object, Chunk* chunk, uint8_t byte) {
     ObjString* name = AS_STRING(chunk->identifiers.values[byte]);
-    IDMap* idMap = getShapeIndexes(vm, object->shapeID);
+    IDMap* idMap = getObjectIndexes(vm, object);
     int index;
     return idMapGet(idMap, name, &index);
 }
@@ -390,14 +390,14 @@ bool getInstanceVariable(VM* vm, Value receiver, Chunk* chunk, uint8_t byte) {
 #endif
 
         ObjString* name = AS_STRING(chunk->identifiers.values[byte]);
-        IDMap* idMap = getShapeIndexes(vm, shapeID);
+        IDMap* idMap = getObjectIndexes(vm, &instance->obj);
         int index;
 
         if (idMapGet(idMap, name, &index)) {
             Value value = instance->fields.values[index];
             pop(vm);
             push(vm, value);
-            writeInlineCache(inlineCache, CACHE_IVAR, shapeID, index);
+            if (shapeID != vm->shapes.dictionaryShapeID) writeInlineCache(inlineCache, CACHE_IVAR, shapeID, index);
             return true;
         }
 
@@ -827,23 +827,34 @@ bool setInstanceVariable(VM* vm, Value receiver, Chunk* chunk, uint8_t byte, Val
             push(vm, value);
             return true;
         }
+        else if (inlineCache->type == CACHE_TRANSITION && inlineCache->id == shapeID) {
+#ifdef DEBUG_TRACE_CACHE
+            printf("Cache hit for adding instance variable: Shape ID %d to Shape ID %d.\n", inlineCache->id, inlineCache->index);
+#endif 
+            instance->obj.shapeID = inlineCache->index;
+            appendObjProperty(vm, instance, value);
+            push(vm, value);
+            return true;
+        }
 
 #ifdef DEBUG_TRACE_CACHE
         printf("Cache miss for setting instance variable: Shape ID %d.\n", shapeID);
 #endif
 
         ObjString* name = AS_STRING(chunk->identifiers.values[byte]);
-        IDMap* idMap = getShapeIndexes(vm, shapeID);
+        IDMap* idMap = getObjectIndexes(vm, &instance->obj);
         int index;
-        if (idMapGet(idMap, name, &index)) instance->fields.values[index] = value;
+        if (idMapGet(idMap, name, &index)) {
+            instance->fields.values[index] = value;
+            if (shapeID != vm->shapes.dictionaryShapeID) writeInlineCache(inlineCache, CACHE_IVAR, shapeID, index);
+        }
         else {
-            index = instance->fields.count;
-            transitionShapeForObject(vm, &instance->obj, name);
-            valueArrayWrite(vm, &instance->fields, value);
-            shapeID = instance->obj.shapeID;
+            addObjProperty(vm, instance, name, value);
+            int nextShapeID = instance->obj.shapeID;
+            if (shapeID != vm->shapes.dictionaryShapeID && nextShapeID != vm->shapes.dictionaryShapeID) {
+                writeInlineCache(inlineCache, CACHE_TRANSITION, shapeID, nextShapeID);
+            }
         }
-
-        writeInlineCache(inlineCache, CACHE_IVAR, shapeID, index);
         push(vm, value);
         return true;
     }
@@ -29,6 +29,8 @@ static void resetCallFrame(VM* vm, int index) {
     frame->closure = NULL;
     frame->ip = NULL;
     frame->slots = NULL;
+    frame->continuation = NULL;
+    frame->nativeSlots = NULL;
     frame->handlerCount = 0;
 }
 
@@ -42,6 +44,7 @@ static void resetStack(VM* vm) {
     vm->stackTop = vm->stack;
     vm->frameCount = 0;
     vm->apiStackDepth = 0;
+    vm->apiFrameCount = 0;
     vm->runningGenerator = NULL;
     vm->openUpvalues = NULL;
     resetCallFrames(vm);
@@ -138,6 +141,18 @@ static int parseConfiguration(void* data, const char* section, const char* name,
     else if (HAS_CONFIG("gc", "gcStressMode")) {
         config->gcStressMode = (bool)atoi(value);
     }
+    else if (HAS_CONFIG("gc", "gcTargetPauseMs")) {
+        config->gcTargetPauseMs = atof(value);
+    }
+    else if (HAS_CONFIG("gc", "gcMaxHeapBytes")) {
+        config->gcMaxHeapBytes = (size_t)atoll(value);
+    }
+    else if (HAS_CONFIG("gc", "gcThroughputGoal")) {
+        config->gcThroughputGoal = atof(value);
+    }
+    else if (HAS_CONFIG("gc", "gcInternMaxLength")) {
+        config->gcInternMaxLength = atoi(value);
+    }
     else if (HAS_CONFIG("gc_generation", "gcEdenHeapSize")) {
         config->gcEdenHeapSize = (size_t)atol(value);
     }
@@ -147,6 +162,18 @@ static int parseConfiguration(void* data, const char* section, const char* name,
     else if (HAS_CONFIG("gc_generation", "gcOldHeapSize")) {
         config->gcOldHeapSize = (size_t)atol(value);
     }
+    else if (HAS_CONFIG("gc_generation", "gcOldCompactRatio")) {
+        config->gcOldCompactRatio = atof(value);
+    }
+    else if (HAS_CONFIG("gc_generation", "gcLargeObjectSize")) {
+        config->gcLargeObjectSize = (size_t)atol(value);
+    }
+    else if (HAS_CONFIG("gc_generation", "gcLargeHeapSize")) {
+        config->gcLargeHeapSize = (size_t)atol(value);
+    }
+    else if (HAS_CONFIG("gc_generation", "gcPretenureRatio")) {
+        config->gcPretenureRatio = atof(value);
+    }
     else {
         return 0;
     }
@@ -154,8 +181,37 @@ static int parseConfiguration(void* data, const char* section, const char* name,
 #undef HAS_CONFIG
 }
 
+static void initDefaultConfiguration(Configuration* config) {
+    memset(config, 0, sizeof(Configuration));
+    config->version = "2.0.0";
+    config->script = "";
+    config->path = "";
+    config->timezone = "UTC";
+
+    config->flagUnusedImport = 1;
+    config->flagUnusedVariable = 1;
+    config->flagMutableVariable = 1;
+
+    config->gcType = "gen";
+    config->gcHeapSize = 10485760;
+    config->gcStressMode = false;
+    config->gcTargetPauseMs = 10;
+    config->gcMaxHeapBytes = 1073741824;
+    config->gcThroughputGoal = 0.95;
+    config->gcInternMaxLength = 256;
+
+    config->gcEdenHeapSize = 1048576;
+    config->gcYoungHeapSize = 3145728;
+    config->gcOldHeapSize = 10485760;
+    config->gcOldCompactRatio = 0;
+    config->gcLargeObjectSize = 131072;
+    config->gcLargeHeapSize = 33554432;
+    config->gcPretenureRatio = 0.9;
+}
+
 static void initConfiguration(VM* vm) {
     Configuration config;
+    initDefaultConfiguration(&config);
     int iniParsed = ini_parse("lox2.ini", parseConfiguration, &config);
     ABORT_IFTRUE(iniParsed < 0, "Can't load 'lox2.ini' configuration file...\n");
     vm->config = config;
@@ -185,6 +241,7 @@ void initVM(VM* vm) {
     initTable(&vm->modules, GC_GENERATION_TYPE_PERMANENT);
     initTable(&vm->strings, GC_GENERATION_TYPE_PERMANENT);
     initShapeTree(vm);
+    initCharStrings(vm);
     initGenericIDMap(vm);
     initLoop(vm);
 
@@ -265,11 +322,36 @@ static void concatenate(VM* vm) {
     push(vm, OBJ_VAL(result));
 }
 
-static void makeArray(VM* vm, uint8_t elementCount) {
+static bool buildString(VM* vm, uint8_t partCount) {
+    int length = 0;
+    for (int i = partCount - 1; i >= 0; i--) {
+        if (!IS_STRING(peek(vm, i))) return false;
+        length += AS_STRING(peek(vm, i))->length;
+    }
+
+    char* chars = ALLOCATE(char, length + 1, GC_GENERATION_TYPE_EDEN);
+    int offset = 0;
+    for (int i = partCount - 1; i >= 0; i--) {
+        ObjString* part = AS_STRING(peek(vm, i));
+        memcpy(chars + offset, part->chars, part->length);
+        offset += part->length;
+    }
+    chars[length] = '\0';
+
+    ObjString* result = takeString(vm, chars, length);
+    pops(vm, partCount);
+    push(vm, OBJ_VAL(result));
+    return true;
+}
+
+static void makeArray(VM* vm, uint8_t elementCount, uint8_t* ip) {
     ObjArray* array = newArray(vm);
+    trackAllocationSite(vm, &array->obj, ip);
     push(vm, OBJ_VAL(array));
     for (int i = elementCount; i > 0; i--) {
-        valueArrayWrite(vm, &array->elements, peek(vm, i));
+        Value element = peek(vm, i);
+        PROCESS_WRITE_BARRIER((Obj*)array, element);
+        valueArrayWrite(vm, &array->elements, element);
     }
     pop(vm);
 
@@ -280,13 +362,16 @@ static void makeArray(VM* vm, uint8_t elementCount) {
     push(vm, OBJ_VAL(array));
 }
 
-static void makeDictionary(VM* vm, uint8_t entryCount) {
+static void makeDictionary(VM* vm, uint8_t entryCount, uint8_t* ip) {
     ObjDictionary* dictionary = newDictionary(vm);
+    trackAllocationSite(vm, &dictionary->obj, ip);
     push(vm, OBJ_VAL(dictionary));
 
     for (int i = 1; i <= entryCount; i++) {
         Value key = peek(vm, 2 * i);
         Value value = peek(vm, 2 * i - 1);
+        PROCESS_WRITE_BARRIER((Obj*)dictionary, key);
+        PROCESS_WRITE_BARRIER((Obj*)dictionary, value);
         dictSet(vm, dictionary, key, value);
     }
     pop(vm);
@@ -349,6 +434,7 @@ static void createCallFrame(VM* vm, ObjClosure* closure, int argCount) {
     frame->closure = closure;
     frame->ip = closure->function->chunk.code;
     frame->slots = vm->stackTop - argCount - 1;
+    frame->continuation = NULL;
 }
 
 static void createGeneratorFrame(VM* vm, ObjClosure* closure, int argCount) {
@@ -363,9 +449,10 @@ static void createGeneratorFrame(VM* vm, ObjClosure* closure, int argCount) {
 }
 
 static bool callClosureAsync(VM* vm, ObjClosure* closure, int argCount) {
-    makeArray(vm, argCount);
+    makeArray(vm, argCount, NULL);
     Value arguments = pop(vm);
     Value result = runGeneratorAsync(vm, OBJ_VAL(closure), AS_ARRAY(arguments));
+    pop(vm);
     push(vm, result);
     return true;
 }
@@ -382,7 +469,7 @@ bool callClosure(VM* vm, ObjClosure* closure, int argCount) {
     }
 
     if (closure->function->arity == -1) {
-        makeArray(vm, argCount);
+        makeArray(vm, argCount, NULL);
         argCount = 1;
     }
 
@@ -400,7 +487,9 @@ static bool callNativeFunction(VM* vm, NativeFunction function, int argCount) {
 }
 
 static bool callNativeMethod(VM* vm, NativeMethod method, int argCount) {
+    int frameCount = vm->frameCount;
     Value result = method(vm, vm->stackTop[-argCount - 1], argCount, vm->stackTop - argCount);
+    if (vm->frameCount > frameCount) return true;
     vm->stackTop -= (size_t)argCount + 1;
     push(vm, result);
     return true;
@@ -419,11 +508,15 @@ static bool callBoundMethod(VM* vm, ObjBoundMethod* boundMethod, int argCount) {
 }
 
 static bool callClass(VM* vm, ObjClass* klass, int argCount) {
-    vm->stackTop[-argCount - 1] = createObject(vm, klass, argCount);
-    Value initializer;
-    if (tableGet(&klass->methods, vm->initString, &initializer)) {
-        return callMethod(vm, initializer, argCount);
+    Value object;
+    if (klass->classType == OBJ_INSTANCE) {
+        object = OBJ_VAL(newInstance(vm, klass));
+        trackAllocationSite(vm, AS_OBJ(object), vm->frames[vm->frameCount - 1].ip);
     }
+    else object = createObject(vm, klass, argCount);
+
+    vm->stackTop[-argCount - 1] = object;
+    if (!IS_NIL(klass->initializer)) return callMethod(vm, klass->initializer, argCount);
     else if (argCount != 0) {
         runtimeError(vm, "Expected 0 argument but got %d.", argCount);
         return false;
@@ -439,15 +532,28 @@ static int getCalleeArity(Value callee) {
     else return 0;
 }
 
-static void callReentrantClosure(VM* vm, Value callee, int argCount) {
+InterpretResult runReentrant(VM* vm, int frameCount) {
+    int apiFrameCount = vm->apiFrameCount;
+    vm->apiFrameCount = frameCount;
     vm->apiStackDepth++;
-    callClosure(vm, AS_CLOSURE(callee), argCount);
     InterpretResult result = run(vm);
-    if (result == INTERPRET_RUNTIME_ERROR) exit(70);
     vm->apiStackDepth--;
+    vm->apiFrameCount = apiFrameCount;
+    return result;
+}
+
+static void callReentrant(VM* vm, Value callee, int argCount) {
+    int frameCount = vm->frameCount;
+    if (IS_CLOSURE(callee)) callClosure(vm, AS_CLOSURE(callee), argCount);
+    else if (IS_BOUND_METHOD(callee)) callBoundMethod(vm, AS_BOUND_METHOD(callee), argCount);
+    else if (IS_NATIVE_METHOD(callee)) callNativeMethod(vm, AS_NATIVE_METHOD(callee)->method, argCount);
+    else callNativeFunction(vm, AS_NATIVE_FUNCTION(callee)->function, argCount);
+
+    if (vm->frameCount > frameCount && runReentrant(vm, frameCount) == INTERPRET_RUNTIME_ERROR) exit(70);
 }
 
 Value callReentrantFunction(VM* vm, Value callee, ...) {
+    push(vm, callee);
     int argCount = getCalleeArity(callee);
     va_list args;
     va_start(args, callee);
@@ -456,8 +562,7 @@ Value callReentrantFunction(VM* vm, Value callee, ...) {
     }
     va_end(args);
 
-    if (IS_CLOSURE(callee)) callReentrantClosure(vm, callee, argCount);
-    else callNativeFunction(vm, AS_NATIVE_FUNCTION(callee)->function, argCount);
+    callReentrant(vm, callee, argCount);
     return pop(vm);
 }
 
@@ -471,17 +576,64 @@ Value callReentrantMethod(VM* vm, Value receiver, Value callee, ...) {
     }
     va_end(args);
 
-    if (IS_CLOSURE(callee)) callReentrantClosure(vm, callee, argCount);
-    else if (IS_BOUND_METHOD(callee)) callBoundMethod(vm, AS_BOUND_METHOD(callee), argCount);
-    else callNativeMethod(vm, AS_NATIVE_METHOD(callee)->method, argCount);
+    callReentrant(vm, callee, argCount);
     return pop(vm);
 }
 
+static bool canCallContinuation(Value callee) {
+    return IS_CLOSURE(callee) && !AS_CLOSURE(callee)->function->isAsync && !AS_CLOSURE(callee)->function->isGenerator;
+}
+
+bool callContinuation(VM* vm, Value* slots, Value callee, NativeContinuation continuation, int argCount, ...) {
+    int arity = getCalleeArity(callee);
+    int pushCount = 0;
+    push(vm, slots[0]);
+    va_list args;
+    va_start(args, argCount);
+    for (int i = 0; i < argCount; i++) {
+        Value arg = va_arg(args, Value);
+        if (i < arity) {
+            push(vm, arg);
+            pushCount++;
+        }
+    }
+    va_end(args);
+
+    if (!canCallContinuation(callee)) {
+        callReentrant(vm, callee, pushCount);
+        return false;
+    }
+
+    if (!callClosure(vm, AS_CLOSURE(callee), pushCount)) exit(70);
+    CallFrame* frame = &vm->frames[vm->frameCount - 1];
+    frame->continuation = continuation;
+    frame->nativeSlots = slots;
+    return true;
+}
+
+Value startContinuation(VM* vm, Value* slots, int argCount, NativeContinuation continuation) {
+    int frameCount = vm->frameCount;
+    Value result = continuation(vm, slots, NIL_VAL);
+    if (vm->frameCount == frameCount) vm->stackTop = slots + argCount + 1;
+    return result;
+}
+
+static bool resumeContinuation(VM* vm, CallFrame* frame, Value result) {
+    int frameCount = vm->frameCount;
+    Value* slots = frame->nativeSlots;
+    Value value = frame->continuation(vm, slots, result);
+    if (vm->frameCount > frameCount) return true;
+
+    vm->stackTop = slots;
+    push(vm, value);
+    return false;
+}
+
 Value callGenerator(VM* vm, ObjGenerator* generator) {
     ObjGenerator* outer = vm->runningGenerator;
     vm->runningGenerator = generator;
     loadGeneratorFrame(vm, generator);
-    InterpretResult result = run(vm);
+    InterpretResult result = runReentrant(vm, vm->frameCount - 1);
     if (result == INTERPRET_RUNTIME_ERROR) exit(70);
     if(vm->runningGenerator->frame->closure->function->name != NULL) vm->runningGenerator = outer;
     return pop(vm);
@@ -531,7 +683,7 @@ static bool invoke(VM* vm, ObjString* name, int argCount) {
 
     if (IS_INSTANCE(receiver)) {
         ObjInstance* instance = AS_INSTANCE(receiver);
-        IDMap* idMap = getShapeIndexes(vm, instance->obj.shapeID);
+        IDMap* idMap = getObjectIndexes(vm, &instance->obj);
         int index;
         if (idMapGet(idMap, name, &index)) {
             Value value = instance->fields.values[index];
@@ -549,6 +701,18 @@ static bool invoke(VM* vm, ObjString* name, int argCount) {
     return invokeFromClass(vm, getObjClass(vm, receiver), name, argCount);
 }
 
+static bool canBorrowArguments(VM* vm, Value receiver, ObjString* name) {
+    if (HAS_OBJ_INTERCEPTOR(receiver, INTERCEPTOR_ON_INVOKE) || IS_NAMESPACE(receiver)) return false;
+    if (IS_INSTANCE(receiver)) {
+        int index;
+        if (idMapGet(getObjectIndexes(vm, AS_OBJ(receiver)), name, &index)) return false;
+    }
+
+    Value method;
+    if (!tableGet(&getObjClass(vm, receiver)->methods, name, &method)) return false;
+    return IS_NATIVE_METHOD(method) && AS_NATIVE_METHOD(method)->isBorrowing;
+}
+
 static bool invokeOperator(VM* vm, ObjString* op, int arity) {
     Value receiver = peek(vm, arity);
     ObjClass* klass = getObjClass(vm, receiver);
@@ -588,7 +752,8 @@ static void defineMethod(VM* vm, ObjString* name, bool isClassMethod) {
     }
 
     tableSet(vm, &klass->methods, name, method);
-    handleInterceptorMethod(vm, klass, name);
+    if (name == vm->initString) klass->initializer = method;
+    handleInterceptorMethod(vm, klass, name, method);
     pop(vm);
 }
 
@@ -615,6 +780,116 @@ static ObjUpvalue* captureUpvalue(VM* vm, Value* local) {
     return createdUpvalue;
 }
 
+static ObjUpvalue* inheritUpvalue(VM* vm, ObjClosure* enclosing, int index) {
+    ObjUpvalue* upvalue = enclosing->upvalues[index];
+    return isBorrowedUpvalue(enclosing, upvalue) ? captureUpvalue(vm, upvalue->location) : upvalue;
+}
+
+static ObjUpvalue* borrowUpvalue(ObjClosure* closure, int index, Value* local) {
+    ObjUpvalue* upvalue = &closure->borrowedUpvalues[index];
+    upvalue->location = local;
+    upvalue->closed = NIL_VAL;
+    upvalue->next = NULL;
+    return upvalue;
+}
+
+static bool iterateRange(int from, int to, Value* index, Value* element) {
+    int length = abs(to - from);
+    if (IS_NIL(*index)) *index = INT_VAL(0);
+    else if (!IS_INT(*index)) return false;
+    else if (AS_INT(*index) >= 0 && AS_INT(*index) >= length) {
+        *index = NIL_VAL;
+        return true;
+    }
+    else *index = INT_VAL(AS_INT(*index) + 1);
+
+    int position = AS_INT(*index);
+    if (position > -1 && position <= length) *element = INT_VAL(from < to ? from + position : from - position);
+    else *element = NIL_VAL;
+    return true;
+}
+
+static bool iterateArray(ObjArray* array, Value* index, Value* element) {
+    int count = array->elements.count;
+    if (IS_NIL(*index)) {
+        if (count == 0) return true;
+        *index = INT_VAL(0);
+    }
+    else if (!IS_INT(*index)) return false;
+    else if (AS_INT(*index) >= 0 && AS_INT(*index) >= count - 1) {
+        *index = NIL_VAL;
+        return true;
+    }
+    else *index = INT_VAL(AS_INT(*index) + 1);
+
+    int position = AS_INT(*index);
+    *element = (position > -1 && position < count) ? array->elements.values[position] : NIL_VAL;
+    return true;
+}
+
+static bool iterateString(VM* vm, ObjString* string, Value* index, Value* element) {
+    bool isAscii = isAsciiObjString(string);
+    if (IS_NIL(*index)) {
+        if (string->length == 0) return true;
+        *index = INT_VAL(0);
+    }
+    else if (!IS_INT(*index)) return false;
+    else if (AS_INT(*index) >= 0 && AS_INT(*index) >= string->length - 1) {
+        *index = NIL_VAL;
+        return true;
+    }
+    else {
+        int position = AS_INT(*index);
+        *index = INT_VAL(isAscii ? position + 1 : position + utf8CodePointOffset(vm, string->chars, position));
+    }
+
+    int position = AS_INT(*index);
+    if (position > -1 && position < string->length) {
+        *element = OBJ_VAL(isAscii ? charString(vm, string->chars[position]) : utf8CodePointAtIndex(vm, string->chars, position));
+    }
+    else *element = NIL_VAL;
+    return true;
+}
+
+static bool iterateDictionary(ObjDictionary* dict, Value* index, Value* element) {
+    int position = 0;
+    if (dict->count > 0 && !IS_NIL(*index)) {
+        position = dictFindIndex(dict, *index);
+        position = (position < 0) ? dict->capacity : position + 1;
+    }
+
+    if (dict->count > 0) {
+        for (; position < dict->capacity; position++) {
+            ObjEntry* entry = &dict->entries[position];
+            if (!IS_UNDEFINED(entry->key)) {
+                *index = entry->key;
+                *element = entry->value;
+                return true;
+            }
+        }
+    }
+    *index = NIL_VAL;
+    return true;
+}
+
+static bool iterateCollection(VM* vm, Value collection, Value* index, Value* element) {
+    if (!IS_OBJ(collection)) return false;
+    ObjClass* klass = AS_OBJ(collection)->klass;
+    if (IS_ARRAY(collection) && klass == vm->arrayClass) return iterateArray(AS_ARRAY(collection), index, element);
+    if (IS_RANGE(collection) && klass == vm->rangeClass) return iterateRange(AS_RANGE(collection)->from, AS_RANGE(collection)->to, index, element);
+    if (IS_STRING(collection) && klass == vm->stringClass) return iterateString(vm, AS_STRING(collection), index, element);
+    if (IS_DICTIONARY(collection) && klass == vm->dictionaryClass) return iterateDictionary(AS_DICTIONARY(collection), index, element);
+    return false;
+}
+
+static const char* globalSlotName(IDMap* indexes, int slot) {
+    for (int i = 0; i < indexes->capacity; i++) {
+        IDEntry* entry = &indexes->entries[i];
+        if (entry->key != NULL && entry->value == slot) return entry->key->chars;
+    }
+    return "?";
+}
+
 static void closeUpvalues(VM* vm, Value* last) {
     while (vm->openUpvalues != NULL && vm->openUpvalues->location >= last) {
         ObjUpvalue* upvalue = vm->openUpvalues;
@@ -649,8 +924,8 @@ InterpretResult run(VM* vm) {
     } while (false)
 
 
-#define CAN_INTERCEPT(receiver, interceptorType, interceptorName) \
-    HAS_OBJ_INTERCEPTOR(receiver, interceptorType) && !matchVariableName(frame->closure->function->name, #interceptorName, (int)strlen(#interceptorName))
+#define CAN_INTERCEPT(receiver, interceptorType) \
+    (HAS_OBJ_INTERCEPTOR(receiver, interceptorType) && frame->closure->function->interceptor != interceptorType)
 
 #define OVERLOAD_OP(op, arity) \
     do { \
@@ -743,6 +1018,28 @@ InterpretResult run(VM* vm) {
                 else RUNTIME_ERROR("Undefined variable '%s'.", name->chars);
                 break;
             }
+            case OP_GET_GLOBAL_VAL: {
+                uint8_t slot = READ_BYTE();
+                ObjModule* module = frame->closure->module;
+                if (slot >= module->valFields.count) RUNTIME_ERROR("Undefined variable '%s'.", globalSlotName(&module->valIndexes, slot));
+                push(vm, module->valFields.values[slot]);
+                break;
+            }
+            case OP_GET_GLOBAL_VAR: {
+                uint8_t slot = READ_BYTE();
+                ObjModule* module = frame->closure->module;
+                if (slot >= module->varFields.count) RUNTIME_ERROR("Undefined variable '%s'.", globalSlotName(&module->varIndexes, slot));
+                push(vm, module->varFields.values[slot]);
+                break;
+            }
+            case OP_SET_GLOBAL_VAR: {
+                uint8_t slot = READ_BYTE();
+                ObjModule* module = frame->closure->module;
+                if (slot >= module->varFields.count) RUNTIME_ERROR("Undefined variable '%s'.", globalSlotName(&module->varIndexes, slot));
+                PROCESS_WRITE_BARRIER((Obj*)module, peek(vm, 0));
+                module->varFields.values[slot] = peek(vm, 0);
+                break;
+            }
             case OP_GET_UPVALUE: {
                 uint8_t slot = READ_BYTE();
                 push(vm, *frame->closure->upvalues[slot]->location);
@@ -757,7 +1054,15 @@ InterpretResult run(VM* vm) {
                 Value receiver = peek(vm, 0);
                 uint8_t byte = READ_BYTE();
 
-                if (CAN_INTERCEPT(receiver, INTERCEPTOR_BEFORE_GET, __beforeGet__) && hasInstanceVariable(vm, AS_OBJ(receiver), &frame->closure->function->chunk, byte)) {
+                if (!HAS_OBJ_INTERCEPTORS(receiver, INTERCEPTOR_GET_MASK)) {
+                    if (!getInstanceVariable(vm, receiver, &frame->closure->function->chunk, byte)) {
+                        ObjString* name = AS_STRING(frame->closure->function->chunk.identifiers.values[byte]);
+                        RUNTIME_ERROR("Undefined property '%s'", name->chars);
+                    }
+                    break;
+                }
+
+                if (CAN_INTERCEPT(receiver, INTERCEPTOR_BEFORE_GET) && hasInstanceVariable(vm, AS_OBJ(receiver), &frame->closure->function->chunk, byte)) {
                     ObjString* name = AS_STRING(frame->closure->function->chunk.identifiers.values[byte]);
                     interceptBeforeGet(vm, receiver, name);
                     LOAD_FRAME();
@@ -768,7 +1073,7 @@ InterpretResult run(VM* vm) {
                     if (interceptUndefinedGet(vm, receiver, name)) LOAD_FRAME();
                     else RUNTIME_ERROR("Undefined property '%s'", name->chars);
                 }
-                else if (CAN_INTERCEPT(receiver, INTERCEPTOR_AFTER_GET, __afterGet__)) {
+                else if (CAN_INTERCEPT(receiver, INTERCEPTOR_AFTER_GET)) {
                     ObjString* name = AS_STRING(frame->closure->function->chunk.identifiers.values[byte]);
                     Value value = pop(vm);
                     interceptAfterGet(vm, receiver, name, value);
@@ -781,7 +1086,14 @@ InterpretResult run(VM* vm) {
                 Value receiver = pop(vm);
                 uint8_t byte = READ_BYTE();
 
-                if (CAN_INTERCEPT(receiver, INTERCEPTOR_BEFORE_SET, __beforeSet__) && hasInstanceVariable(vm, AS_OBJ(receiver), &frame->closure->function->chunk, byte)) {
+                if (!HAS_OBJ_INTERCEPTORS(receiver, INTERCEPTOR_SET_MASK)) {
+                    if (!setInstanceVariable(vm, receiver, &frame->closure->function->chunk, byte, value)) {
+                        return INTERPRET_RUNTIME_ERROR;
+                    }
+                    break;
+                }
+
+                if (CAN_INTERCEPT(receiver, INTERCEPTOR_BEFORE_SET) && hasInstanceVariable(vm, AS_OBJ(receiver), &frame->closure->function->chunk, byte)) {
                     ObjString* name = AS_STRING(frame->closure->function->chunk.identifiers.values[byte]);
                     interceptBeforeSet(vm, receiver, name, value);
                     value = pop(vm);
@@ -791,7 +1103,7 @@ InterpretResult run(VM* vm) {
                 if (!setInstanceVariable(vm, receiver, &frame->closure->function->chunk, byte, value)) {
                     return INTERPRET_RUNTIME_ERROR;
                 }
-                else if (CAN_INTERCEPT(receiver, INTERCEPTOR_AFTER_GET, __afterSet__)) {
+                else if (CAN_INTERCEPT(receiver, INTERCEPTOR_AFTER_SET)) {
                     ObjString* name = AS_STRING(frame->closure->function->chunk.identifiers.values[byte]);
                     interceptAfterSet(vm, receiver, name);
                     LOAD_FRAME();
@@ -802,7 +1114,7 @@ InterpretResult run(VM* vm) {
                 Value receiver = peek(vm, 0);
                 uint8_t byte = READ_BYTE();
 
-                if (CAN_INTERCEPT(receiver, INTERCEPTOR_BEFORE_GET, __beforeGet__) && hasInstanceVariable(vm, AS_OBJ(receiver), &frame->closure->function->chunk, byte)) {
+                if (CAN_INTERCEPT(receiver, INTERCEPTOR_BEFORE_GET) && hasInstanceVariable(vm, AS_OBJ(receiver), &frame->closure->function->chunk, byte)) {
                     ObjString* name = AS_STRING(frame->closure->function->chunk.identifiers.values[byte]);
                     interceptBeforeGet(vm, receiver, name);
                     LOAD_FRAME();
@@ -817,7 +1129,7 @@ InterpretResult run(VM* vm) {
                     if (interceptUndefinedGet(vm, receiver, name)) LOAD_FRAME();
                     else return INTERPRET_RUNTIME_ERROR;
                 }
-                else if (CAN_INTERCEPT(receiver, INTERCEPTOR_AFTER_GET, __afterGet__)) {
+                else if (CAN_INTERCEPT(receiver, INTERCEPTOR_AFTER_GET)) {
                     ObjString* name = AS_STRING(frame->closure->function->chunk.identifiers.values[byte]);
                     Value value = pop(vm);
                     interceptAfterGet(vm, receiver, name, value);
@@ -828,28 +1140,15 @@ InterpretResult run(VM* vm) {
             case OP_GET_SUBSCRIPT: {
                 if (IS_INT(peek(vm, 0))) {
                     int index = AS_INT(peek(vm, 0));
-                    if (IS_STRING(peek(vm, 0))) {
+                    if (IS_STRING(peek(vm, 1)) && index >= 0 && index <= AS_STRING(peek(vm, 1))->length) {
                         pop(vm);
                         ObjString* string = AS_STRING(pop(vm));
-                        if (index < 0 || index > string->length) {
-                            throwNativeException(vm, "clox.std.lang.IndexOutOfBoundsException", "String index is out of bound: %d.", index);
-                        }
-                        else {
-                            char chars[2] = { string->chars[index], '\0' };
-                            ObjString* element = copyString(vm, chars, 1);
-                            push(vm, OBJ_VAL(element));
-                        }
+                        push(vm, OBJ_VAL(charString(vm, string->chars[index])));
                     }
-                    else if (IS_ARRAY(peek(vm, 0))) {
+                    else if (IS_ARRAY(peek(vm, 1)) && index >= 0 && index < AS_ARRAY(peek(vm, 1))->elements.count) {
                         pop(vm);
                         ObjArray* array = AS_ARRAY(pop(vm));
-                        if (index < 0 || index > array->elements.count) {
-                            throwNativeException(vm, "clox.std.lang.IndexOutOfBoundsException", "Array index is out of bound: %d.", index);
-                        }
-                        else {
-                            Value element = array->elements.values[index];
-                            push(vm, element);
-                        }
+                        push(vm, array->elements.values[index]);
                     }
                     else OVERLOAD_OP([], 1);
                 }
@@ -891,28 +1190,15 @@ InterpretResult run(VM* vm) {
                 }
                 else if (IS_INT(peek(vm, 0))) {
                     int index = AS_INT(peek(vm, 0));
-                    if (IS_STRING(peek(vm, 0))) {
+                    if (IS_STRING(peek(vm, 1)) && index >= 0 && index <= AS_STRING(peek(vm, 1))->length) {
                         pop(vm);
                         ObjString* string = AS_STRING(pop(vm));
-                        if (index < 0 || index > string->length) {
-                            throwNativeException(vm, "clox.std.lang.IndexOutOfBoundsException", "String index is out of bound: %d.", index);
-                        }
-                        else {
-                            char chars[2] = { string->chars[index], '\0' };
-                            ObjString* element = copyString(vm, chars, 1);
-                            push(vm, OBJ_VAL(element));
-                        }
+                        push(vm, OBJ_VAL(charString(vm, string->chars[index])));
                     }
-                    else if (IS_ARRAY(peek(vm, 0))) {
+                    else if (IS_ARRAY(peek(vm, 1)) && index >= 0 && index < AS_ARRAY(peek(vm, 1))->elements.count) {
                         pop(vm);
                         ObjArray* array = AS_ARRAY(pop(vm));
-                        if (index < 0 || index > array->elements.count) {
-                            throwNativeException(vm, "clox.std.lang.IndexOutOfBoundsException", "Array index is out of bound: %d.", index);
-                        }
-                        else {
-                            Value element = array->elements.values[index];
-                            push(vm, element);
-                        }
+                        push(vm, array->elements.values[index]);
                     }
                     else OVERLOAD_OP([], 1);
                 }
@@ -965,6 +1251,13 @@ InterpretResult run(VM* vm) {
                 else OVERLOAD_OP(+, 1);
                 break;
             }
+            case OP_BUILD_STRING: {
+                uint8_t partCount = READ_BYTE();
+                if (!buildString(vm, partCount)) {
+                    throwNativeException(vm, "clox.std.lang.IllegalArgumentException", "Operands must be strings for string interpolation.");
+                }
+                break;
+            }
             case OP_SUBTRACT: {
                 if (IS_INT(peek(vm, 0)) && IS_INT(peek(vm, 1))) BINARY_INT_OP(INT_VAL, -);
                 else if (IS_NUMBER(peek(vm, 0)) && IS_NUMBER(peek(vm, 1))) BINARY_NUMBER_OP(NUMBER_VAL, -);
@@ -1031,9 +1324,57 @@ InterpretResult run(VM* vm) {
                 if (IS_NIL(peek(vm, 0)) || IS_UNDEFINED(peek(vm, 0))) frame->ip += offset;
                 break;
             }
+            case OP_JUMP_IF_INT_BOUNDS: {
+                uint16_t offset = READ_SHORT();
+                if (IS_INT(peek(vm, 0)) && IS_INT(peek(vm, 1))) frame->ip += offset;
+                break;
+            }
             case OP_LOOP: {
                 uint16_t offset = READ_SHORT();
                 frame->ip -= offset;
+                if (vm->gc->isCompactionPending && vm->apiStackDepth == 0) compactHeap(vm);
+                break;
+            }
+            case OP_FOR_ITER: {
+                Value* collection = &frame->slots[READ_BYTE()];
+                Value* index = &frame->slots[READ_BYTE()];
+                uint16_t exitOffset = READ_SHORT();
+                uint16_t bodyOffset = READ_SHORT();
+                Value element;
+
+                if (iterateCollection(vm, *collection, index, &element)) {
+                    if (IS_NIL(*index)) frame->ip += exitOffset;
+                    else {
+                        push(vm, element);
+                        frame->ip += bodyOffset;
+                    }
+                }
+                break;
+            }
+            case OP_FOR_ITER_RANGE: {
+                Value* collection = &frame->slots[READ_BYTE()];
+                Value* index = &frame->slots[READ_BYTE()];
+                uint16_t exitOffset = READ_SHORT();
+                uint16_t bodyOffset = READ_SHORT();
+                Value element;
+
+                bool isIterated;
+                if (IS_INT(collection[0]) && IS_INT(collection[1])) {
+                    isIterated = iterateRange(AS_INT(collection[0]), AS_INT(collection[1]), index, &element);
+                    if (!isIterated) {
+                        collection[0] = OBJ_VAL(newRange(vm, AS_INT(collection[0]), AS_INT(collection[1])));
+                        collection[1] = NIL_VAL;
+                    }
+                }
+                else isIterated = iterateCollection(vm, *collection, index, &element);
+
+                if (isIterated) {
+                    if (IS_NIL(*index)) frame->ip += exitOffset;
+                    else {
+                        push(vm, element);
+                        frame->ip += bodyOffset;
+                    }
+                }
                 break;
             }
             case OP_CALL: {
@@ -1062,7 +1403,7 @@ InterpretResult run(VM* vm) {
                 uint8_t argCount = READ_BYTE();
                 Value receiver = peek(vm, argCount);
 
-                if (CAN_INTERCEPT(receiver, INTERCEPTOR_ON_INVOKE, __onInvoke__) && hasMethod(vm, getObjClass(vm, receiver), method)) {
+                if (CAN_INTERCEPT(receiver, INTERCEPTOR_ON_INVOKE) && hasMethod(vm, getObjClass(vm, receiver), method)) {
                     interceptOnInvoke(vm, receiver, method, argCount);
                     LOAD_FRAME();
                 }
@@ -1090,7 +1431,7 @@ InterpretResult run(VM* vm) {
                 uint8_t argCount = READ_BYTE();
                 Value receiver = peek(vm, argCount);
 
-                if (CAN_INTERCEPT(receiver, INTERCEPTOR_ON_INVOKE, __onInvoke__) && hasMethod(vm, getObjClass(vm, receiver), method)) {
+                if (CAN_INTERCEPT(receiver, INTERCEPTOR_ON_INVOKE) && hasMethod(vm, getObjClass(vm, receiver), method)) {
                     interceptOnInvoke(vm, receiver, method, argCount);
                     LOAD_FRAME();
                 }
@@ -1107,7 +1448,20 @@ InterpretResult run(VM* vm) {
             }
             case OP_CLOSURE: {
                 ObjFunction* function = AS_FUNCTION(READ_IDENTIFIER());
+                if (function->upvalueCount == 0) {
+                    // Every evaluation yields the same closure, so evaluations compare equal and share their properties.
+                    if (function->closure == NULL || function->closure->module != frame->closure->module) {
+                        function->closure = newClosure(vm, function);
+                        function->closure->module = frame->closure->module;
+                        PROCESS_WRITE_BARRIER((Obj*)function, OBJ_VAL(function->closure));
+                    }
+                    push(vm, OBJ_VAL(function->closure));
+                    break;
+                }
+
                 ObjClosure* closure = newClosure(vm, function);
+                closure->module = frame->closure->module;
+                trackAllocationSite(vm, &closure->obj, frame->ip);
                 push(vm, OBJ_VAL(closure));
                 for (int i = 0; i < closure->upvalueCount; i++) {
                     uint8_t isLocal = READ_BYTE();
@@ -1116,8 +1470,36 @@ InterpretResult run(VM* vm) {
                         closure->upvalues[i] = captureUpvalue(vm, frame->slots + index);
                     }
                     else {
-                        closure->upvalues[i] = frame->closure->upvalues[index];
+                        closure->upvalues[i] = inheritUpvalue(vm, frame->closure, index);
                     }
+                    PROCESS_WRITE_BARRIER((Obj*)closure, OBJ_VAL(closure->upvalues[i]));
+                }
+                break;
+            }
+            case OP_BORROW_CLOSURE: {
+                ObjFunction* function = AS_FUNCTION(READ_IDENTIFIER());
+                // Only emitted for the last argument of an invoke, which directly follows the upvalue operands.
+                uint8_t* invokeIp = frame->ip + function->upvalueCount * 2;
+                bool canBorrow = false;
+                if (!function->isGenerator && !function->isAsync && (*invokeIp == OP_INVOKE || *invokeIp == OP_OPTIONAL_INVOKE)) {
+                    ObjString* method = AS_STRING(frame->closure->function->chunk.identifiers.values[invokeIp[1]]);
+                    canBorrow = canBorrowArguments(vm, peek(vm, invokeIp[2] - 1), method);
+                }
+
+                ObjClosure* closure = canBorrow ? newBorrowedClosure(vm, function) : newClosure(vm, function);
+                closure->module = frame->closure->module;
+                push(vm, OBJ_VAL(closure));
+                for (int i = 0; i < closure->upvalueCount; i++) {
+                    uint8_t isLocal = READ_BYTE();
+                    uint8_t index = READ_BYTE();
+                    ObjUpvalue* upvalue = isLocal ? NULL : frame->closure->upvalues[index];
+                    if (canBorrow && (isLocal || isBorrowedUpvalue(frame->closure, upvalue))) {
+                        closure->upvalues[i] = borrowUpvalue(closure, i, isLocal ? frame->slots + index : upvalue->location);
+                        continue;
+                    }
+
+                    closure->upvalues[i] = isLocal ? captureUpvalue(vm, frame->slots + index) : inheritUpvalue(vm, frame->closure, index);
+                    PROCESS_WRITE_BARRIER((Obj*)closure, OBJ_VAL(closure->upvalues[i]));
                 }
                 break;
             }
@@ -1177,12 +1559,12 @@ InterpretResult run(VM* vm) {
                 break;
             case OP_ARRAY: {
                 uint8_t elementCount = READ_BYTE();
-                makeArray(vm, elementCount);
+                makeArray(vm, elementCount, frame->ip);
                 break;
             }
             case OP_DICTIONARY: {
                 uint8_t entryCount = READ_BYTE();
-                makeDictionary(vm, entryCount);
+                makeDictionary(vm, entryCount, frame->ip);
                 break;
             }
             case OP_RANGE: {
@@ -1301,7 +1683,7 @@ InterpretResult run(VM* vm) {
 
                 ObjString* name = frame->closure->function->name;
                 Value receiver = peek(vm, frame->closure->function->arity + 1);
-                if (CAN_INTERCEPT(receiver, INTERCEPTOR_ON_THROW, __onThrow__) && hasInterceptableMethod(vm, receiver, name)) {
+                if (CAN_INTERCEPT(receiver, INTERCEPTOR_ON_THROW) && hasInterceptableMethod(vm, receiver, name)) {
                     pop(vm);
                     interceptOnThrow(vm, receiver, name, OBJ_VAL(exception));
                     LOAD_FRAME();
@@ -1360,11 +1742,15 @@ InterpretResult run(VM* vm) {
                 }
 
                 if (!frame->closure->function->isGenerator && !frame->closure->function->isAsync) vm->stackTop = frame->slots;
-                push(vm, result);
-                if (vm->apiStackDepth > 0) return INTERPRET_OK;
+                if (frame->continuation == NULL) push(vm, result);
+                else if (resumeContinuation(vm, frame, result)) {
+                    LOAD_FRAME();
+                    break;
+                }
+                if (vm->frameCount <= vm->apiFrameCount) return INTERPRET_OK;
                 LOAD_FRAME();
 
-                if (CAN_INTERCEPT(receiver, INTERCEPTOR_ON_RETURN, __onReturn__) && hasInterceptableMethod(vm, receiver, name)) {
+                if (CAN_INTERCEPT(receiver, INTERCEPTOR_ON_RETURN) && hasInterceptableMethod(vm, receiver, name)) {
                     interceptOnReturn(vm, receiver, name, result);
                     LOAD_FRAME();
                 }
@@ -1387,12 +1773,12 @@ InterpretResult run(VM* vm) {
                     return INTERPRET_OK;
                 }
 
-                if (!frame->closure->function->isGenerator && !frame->closure->function->isAsync) vm->stackTop = frame->slots;
+                if (!frame->closure->function->isGenerator && !frame->closure->function->isAsync) vm->stackTop = vm->frames[vm->frameCount].slots;
                 push(vm, result);
-                if (vm->apiStackDepth > 0) return INTERPRET_OK;
+                if (vm->frameCount <= vm->apiFrameCount) return INTERPRET_OK;
                 LOAD_FRAME();
 
-                if (CAN_INTERCEPT(receiver, INTERCEPTOR_ON_RETURN, __onReturn__) && hasInterceptableMethod(vm, receiver, name)) {
+                if (CAN_INTERCEPT(receiver, INTERCEPTOR_ON_RETURN) && hasInterceptableMethod(vm, receiver, name)) {
                     interceptOnReturn(vm, receiver, name, result);
                     LOAD_FRAME();
                 }
@@ -1404,13 +1790,13 @@ InterpretResult run(VM* vm) {
                 Value receiver = vm->runningGenerator->frame->slots[0];
                 saveGeneratorFrame(vm, vm->runningGenerator, frame, result);
 
-                if (CAN_INTERCEPT(receiver, INTERCEPTOR_ON_YIELD, __onYield__) && hasInterceptableMethod(vm, receiver, name)) {
+                if (CAN_INTERCEPT(receiver, INTERCEPTOR_ON_YIELD) && hasInterceptableMethod(vm, receiver, name)) {
                     interceptOnYield(vm, receiver, name, result);
                     LOAD_FRAME();
                 }
 
                 vm->frameCount--;
-                if (vm->apiStackDepth > 0) return INTERPRET_OK;
+                if (vm->frameCount <= vm->apiFrameCount) return INTERPRET_OK;
                 LOAD_FRAME();
                 break;
             }
@@ -1429,7 +1815,7 @@ InterpretResult run(VM* vm) {
                 if (generator->state == GENERATOR_RETURN) vm->runningGenerator->frame->ip++;
                 else {
                     vm->frameCount--;
-                    if (vm->apiStackDepth > 0) return INTERPRET_OK;
+                    if (vm->frameCount <= vm->apiFrameCount) return INTERPRET_OK;
                     LOAD_FRAME();
                 }
                 break;
@@ -1438,19 +1824,28 @@ InterpretResult run(VM* vm) {
                 Value result = peek(vm, 0);
                 ObjString* name = frame->closure->function->name;
                 Value receiver = vm->runningGenerator->frame->slots[0];
+                bool canIntercept = CAN_INTERCEPT(receiver, INTERCEPTOR_ON_AWAIT) && hasInterceptableMethod(vm, receiver, name);
+
+                if (!canIntercept && (!IS_PROMISE(result) || AS_PROMISE(result)->state == PROMISE_FULFILLED)) {
+                    if (IS_PROMISE(result)) {
+                        pop(vm);
+                        push(vm, AS_PROMISE(result)->value);
+                    }
+                    break;
+                }
 
                 if (!IS_PROMISE(result)) {
                     result = OBJ_VAL(promiseWithFulfilled(vm, result));
                 }
                 saveGeneratorFrame(vm, vm->runningGenerator, frame, result);
 
-                if (CAN_INTERCEPT(receiver, INTERCEPTOR_ON_AWAIT, __onAwait__) && hasInterceptableMethod(vm, receiver, name)) {
+                if (canIntercept) {
                     interceptOnAwait(vm, receiver, name, result);
                     LOAD_FRAME();
                 }
 
                 vm->frameCount--;
-                if (vm->apiStackDepth > 0) return INTERPRET_OK;
+                if (vm->frameCount <= vm->apiFrameCount) return INTERPRET_OK;
                 LOAD_FRAME();
                 break;
             }
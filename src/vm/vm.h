@@ -29,10 +29,14 @@
         } \
     } while (false)
 
+typedef Value (*NativeContinuation)(VM* vm, Value* slots, Value result);
+
 struct CallFrame {
     ObjClosure* closure;
     uint8_t* ip;
     Value* slots;
+    NativeContinuation continuation;
+    Value* nativeSlots;
     uint8_t handlerCount;
     ExceptionHandler handlerStack[UINT4_MAX];
 };
@@ -56,10 +60,18 @@ typedef struct {
     const char* gcType;
     size_t gcHeapSize;
     bool gcStressMode;
+    double gcTargetPauseMs;
+    size_t gcMaxHeapBytes;
+    double gcThroughputGoal;
+    int gcInternMaxLength;
 
     size_t gcEdenHeapSize;
     size_t gcYoungHeapSize;
     size_t gcOldHeapSize;
+    double gcOldCompactRatio;
+    size_t gcLargeObjectSize;
+    size_t gcLargeHeapSize;
+    double gcPretenureRatio;
 } Configuration;
 
 struct VM {
@@ -99,6 +111,7 @@ struct VM {
     Value stack[STACK_MAX];
     Value* stackTop;
     int apiStackDepth;
+    int apiFrameCount;
     ObjGenerator* runningGenerator;
     uv_loop_t* eventLoop;
 
@@ -125,6 +138,7 @@ struct VM {
 
     ObjString* initString;
     ObjString* voidString;
+    ObjString* charStrings[UINT8_MAX + 1];
     ObjModule* currentModule;
     ObjUpvalue* openUpvalues;
     uint64_t objectIndex;
@@ -143,11 +157,14 @@ bool callClosure(VM* vm, ObjClosure* closure, int argCount);
 bool callMethod(VM* vm, Value method, int argCount);
 Value callReentrantFunction(VM* vm, Value callee, ...);
 Value callReentrantMethod(VM* vm, Value receiver, Value callee, ...);
+bool callContinuation(VM* vm, Value* slots, Value callee, NativeContinuation continuation, int argCount, ...);
+Value startContinuation(VM* vm, Value* slots, int argCount, NativeContinuation continuation);
 Value callGenerator(VM* vm, ObjGenerator* generator);
 void runtimeError(VM* vm, const char* format, ...);
 char* readFile(const char* path);
 bool bindMethod(VM* vm, ObjClass* klass, ObjString* name);
 InterpretResult run(VM* vm);
+InterpretResult runReentrant(VM* vm, int frameCount);
 InterpretResult interpret(VM* vm, const char* source);
 
 #endif // !clox_vm_h